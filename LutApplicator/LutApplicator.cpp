@@ -2,14 +2,30 @@
 
 #include "LutApplicator.h"
 #include "FolderWatcher.h"
+#include "LutVerifier.h"
+#include "AsyncFileIO.h"
+#include "ImageStats.h"
+#include "RouteConfig.h"
+#include "LutCache.h"
+#include "WorkerPool.h"
 #include <iostream>
 #include <filesystem>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <set>
+#include <fstream>
 #include <codecvt> // 用于 string/wstring 转换
 #include <windows.h> // 用于 Sleep
 
 float toFloat[256]; //预计算 0-255 到 0.0-1.0 的映射，避免在千万次循环里做除法
 
+const std::string lutPath = "D:/S5/luts/std pt160h new.cube"; // 没有路由配置时使用的默认 LUT
+
+bool collectStats = false; // --stats：在应用 LUT 时顺带输出质检统计 JSON
+
 namespace fs = std::filesystem;
 
 // 简单的宽字符转多字节字符辅助函数
@@ -20,60 +36,266 @@ std::string wstringToString(const std::wstring& wstr) {
     WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &strTo[0], size_needed, NULL, NULL);
     return strTo;
 }
-bool runPipeline(const std::string& sourcePath, const std::string& outputPath, int quality) {
 
+// 对 [begin, end) 范围的像素应用 LUT（原地修改）
+// WithStats 为编译期开关：不统计时内循环与原来完全一致
+template <bool WithStats>
+void applyLutRange(unsigned char* pixels, int begin, int end, const LutChain& luts, ImageStats* stats) {
+    int channels = 3; // RGB
 
+    for (int i = begin; i < end; ++i) {
+        int idx = i * channels;
 
-    std::cout << "------------------------------------------------" << std::endl;
-    std::cout << ">>> 开始处理文件: " << sourcePath << std::endl;
+        // A. 获取原始像素 (归一化)
+        int r0 = pixels[idx + 0];
+        int g0 = pixels[idx + 1];
+        int b0 = pixels[idx + 2];
+
+        // B. 计算插值，LUT 链依次应用，中间结果截断到 [0,1] 再喂给下一个
+        RGB out = luts[0]->apply(toFloat[r0], toFloat[g0], toFloat[b0]);
+        for (size_t n = 1; n < luts.size(); ++n) {
+            out = luts[n]->apply(std::clamp(out.r, 0.0f, 1.0f), std::clamp(out.g, 0.0f, 1.0f), std::clamp(out.b, 0.0f, 1.0f));
+        }
 
-    ImageProcessor pixelProcessor;
+        // C. 写回像素 (反归一化 + 限制范围)
+        // 加 0.5f 是为了四舍五入
+        unsigned char r1 = static_cast<unsigned char>(std::clamp(out.r * 255.0f + 0.5f, 0.0f, 255.0f));
+        unsigned char g1 = static_cast<unsigned char>(std::clamp(out.g * 255.0f + 0.5f, 0.0f, 255.0f));
+        unsigned char b1 = static_cast<unsigned char>(std::clamp(out.b * 255.0f + 0.5f, 0.0f, 255.0f));
+        pixels[idx + 0] = r1;
+        pixels[idx + 1] = g1;
+        pixels[idx + 2] = b1;
+
+        // D. 顺带统计，像素还在寄存器里，省掉对输出 JPG 的二次解码
+        if constexpr (WithStats) {
+            stats->add(r0, g0, b0, r1, g1, b1);
+        }
+    }
+}
 
-    if (!pixelProcessor.load(sourcePath)) {
-        std::cerr << "错误: 加载源图像失败: " << pixelProcessor.getLastError() << std::endl;
-        return false;
+// 对整幅图应用 LUT（原地修改）；传入 stats 时顺带收集质检统计
+void applyLut(ImageProcessor& pixelProcessor, const LutChain& luts, ImageStats* stats = nullptr) {
+    unsigned char* pixels = pixelProcessor.getPixelData();
+    int pixelCount = pixelProcessor.getWidth() * pixelProcessor.getHeight();
+
+    if (stats) {
+        *stats = ImageStats();
+        applyLutRange<true>(pixels, 0, pixelCount, luts, stats);
+        stats->finalize();
+    }
+    else {
+        applyLutRange<false>(pixels, 0, pixelCount, luts, nullptr);
+    }
+}
+
+// 质检统计旁车文件路径：<输出文件>.stats.json
+std::string statsSidecarPath(const std::string& outputPath) {
+    return outputPath + ".stats.json";
+}
+
+// 每条路由运行时的上下文，作为 userData 交给它自己的 FolderWatcher
+struct RouteContext {
+    Route route;
+    int queueId = -1; // 在共享线程池中的队列
+    std::vector<std::string> lutKeys; // 规范化后的 LUT 链，热更新时按它匹配，不必再访问文件系统
+    FolderWatcher watcher;
+};
+
+LutCache lutCache;     // 所有路由共享，同一个 .cube 只加载一次
+WorkerPool workerPool; // 所有路由共享的工作线程
+AsyncFileIO asyncIO;   // --async-io 时启用
+
+std::mutex pendingMutex;
+std::unordered_map<std::string, JobPriority> pendingOutputs; // 已排队、尚未开始处理的输出 -> 优先级，合并同一文件的连续事件
+std::atomic<unsigned long long> jobCounter{ 0 };
+
+// 同一输出可能被两个任务先后处理，临时文件名带上任务号避免互相覆盖
+std::string makeTempPath(const std::string& outputPath) {
+    return outputPath + "." + std::to_string(++jobCounter) + ".tmp_lut_proc";
+}
+
+// 任务开始处理，之后再来的事件需要重新排队
+void markStarted(const std::string& outputPath) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pendingOutputs.erase(outputPath);
+}
+
+// 同一输出的新旧任务可能同时在不同线程上处理，后完成的不一定是新的。
+// 每个任务入队时领一个递增的世代号，发布时比已发布的更旧就丢弃
+unsigned long long generationCounter = 0; // 在 pendingMutex 下递增
+std::mutex publishMutex;
+std::unordered_map<std::string, unsigned long long> publishedGenerations; // 输出路径 -> 已发布的世代号
+
+enum class PublishResult {
+    Published,
+    Superseded, // 已有更新的任务发布过，结果被丢弃
+    Failed
+};
+
+// 已交付的输出及其所用 LUT 版本，只记录开启了 reprocess 的路由
+struct DeliveredOutput {
+    const RouteContext* route = nullptr;
+    std::string sourcePath;
+    std::vector<uint64_t> lutVersions;
+};
+
+std::mutex deliveredMutex;
+std::unordered_map<std::string, DeliveredOutput> deliveredOutputs; // 输出路径 -> 记录
+
+void enqueueJob(const RouteContext* route, const std::string& sourcePath, const std::string& outputPath, JobPriority priority);
+
+// 输出落盘后登记版本；若处理期间 LUT 已经更新，立即在后台重做一次
+void recordDelivered(const RouteContext* route, const std::string& sourcePath, const std::string& outputPath,
+    const std::vector<uint64_t>& lutVersions) {
+    if (!route->route.reprocessOnLutChange) return;
+
+    {
+        std::lock_guard<std::mutex> lock(deliveredMutex);
+        DeliveredOutput& delivered = deliveredOutputs[outputPath];
+        delivered.route = route;
+        delivered.sourcePath = sourcePath;
+        delivered.lutVersions = lutVersions;
+    }
+
+    if (lutCache.isStale(route->lutKeys, lutVersions)) {
+        enqueueJob(route, sourcePath, outputPath, JobPriority::Background);
+    }
+}
+
+// LUT 热更新完成（在 LutCache 的后台线程上调用）：把用旧版本生成的输出以低优先级重新排队
+void onLutReloaded(const std::string& lutFile, uint64_t version) {
+    std::cout << "[LUT 已更新] " << lutFile << " -> 版本 " << version << std::endl;
+
+    // 持锁期间只做内存比较：只挑出 LUT 链里含有这个文件的输出
+    std::vector<std::pair<std::string, DeliveredOutput>> affected;
+    {
+        std::lock_guard<std::mutex> lock(deliveredMutex);
+        for (const auto& [outputPath, delivered] : deliveredOutputs) {
+            const std::vector<std::string>& keys = delivered.route->lutKeys;
+            if (std::find(keys.begin(), keys.end(), lutFile) != keys.end()) {
+                affected.emplace_back(outputPath, delivered);
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string, DeliveredOutput>> stale;
+    std::vector<std::string> gone;
+    for (auto& [outputPath, delivered] : affected) {
+        // 交付时已经用上了新版本的不用重做
+        if (!lutCache.isStale(delivered.route->lutKeys, delivered.lutVersions)) continue;
+
+        std::error_code ec;
+        if (!fs::exists(delivered.sourcePath, ec)) {
+            gone.push_back(outputPath); // 源文件已被移走，不再跟踪
+            continue;
+        }
+        stale.emplace_back(std::move(outputPath), std::move(delivered));
     }
-    std::cout << "尺寸: " << pixelProcessor.getWidth() << "x" << pixelProcessor.getHeight() << std::endl;
 
-    Lut3D lut;
-    std::string lutPath = "D:/S5/luts/std pt160h new.cube"; // 暂时硬编码
-    std::cout << "正在加载 LUT: " << lutPath << std::endl;
-    if (!lut.load(lutPath)) {
-        std::cerr << "错误: LUT 加载失败！" << std::endl;
+    if (!gone.empty()) {
+        std::lock_guard<std::mutex> lock(deliveredMutex);
+        for (const std::string& outputPath : gone) {
+            deliveredOutputs.erase(outputPath);
+        }
+    }
+
+    if (!stale.empty()) {
+        std::cout << "后台重新处理 " << stale.size() << " 张已输出的图片" << std::endl;
+    }
+    for (const auto& [outputPath, delivered] : stale) {
+        enqueueJob(delivered.route, delivered.sourcePath, outputPath, JobPriority::Background);
+    }
+}
+
+// 源文件被删除或改名移走：不再跟踪它的输出，deliveredOutputs 只保留仍然存在的源文件
+void forgetDelivered(const std::string& outputPath) {
+    std::lock_guard<std::mutex> lock(deliveredMutex);
+    deliveredOutputs.erase(outputPath);
+}
+
+// 写质检统计旁车文件的临时文件，之后和输出一起由 publishOutput 改名到位
+bool writeStatsSidecar(const std::string& outputPath, const ImageStats& stats, std::string& tempPath) {
+    tempPath = makeTempPath(statsSidecarPath(outputPath));
+
+    std::ofstream sidecar(tempPath, std::ios::binary | std::ios::trunc);
+    sidecar << stats.toJson();
+    sidecar.close();
+    if (!sidecar) {
+        std::cerr << "错误: 写入统计文件失败: " << tempPath << std::endl;
+        std::error_code ec;
+        fs::remove(tempPath, ec);
         return false;
     }
+    return true;
+}
 
-    std::cout << "正在应用 LUT..." << std::endl;
-    unsigned char* pixels = pixelProcessor.getPixelData();
-    int width = pixelProcessor.getWidth();
-    int height = pixelProcessor.getHeight();
-    int channels = 3; // RGB
+// 把临时文件改名为最终输出；sidecarTemp 非空时先把旁车文件改名到位，
+// 看板看到输出 JPG 时旁车文件一定已经完整存在。
+// 世代号的检查和改名在同一把锁下完成，旧任务的结果不会盖掉新任务已发布的输出
+PublishResult publishOutput(const std::string& tempPath, const std::string& outputPath, const std::string& sidecarTemp,
+    unsigned long long generation) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    std::error_code ec;
+
+    unsigned long long& published = publishedGenerations[outputPath];
+    if (generation < published) {
+        std::cout << "已有更新的结果，丢弃旧版本的输出: " << outputPath << std::endl;
+        fs::remove(tempPath, ec);
+        if (!sidecarTemp.empty()) fs::remove(sidecarTemp, ec);
+        return PublishResult::Superseded;
+    }
 
-    for (int i = 0; i < width * height; ++i) {
-        int idx = i * channels;
+    if (!sidecarTemp.empty()) {
+        fs::rename(sidecarTemp, statsSidecarPath(outputPath), ec);
+        if (ec) {
+            std::cerr << "错误: 统计文件重命名失败: " << ec.message() << std::endl;
+            fs::remove(sidecarTemp, ec);
+            fs::remove(tempPath, ec);
+            return PublishResult::Failed;
+        }
+    }
 
-        // A. 获取原始像素 (归一化)
-        float r = toFloat[pixels[idx + 0]];
-        float g = toFloat[pixels[idx + 1]];
-        float b = toFloat[pixels[idx + 2]];
+    fs::rename(tempPath, outputPath, ec); // 覆盖已有的旧输出
+    if (ec) {
+        std::cerr << "错误: 文件重命名失败: " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+        if (!sidecarTemp.empty()) fs::remove(statsSidecarPath(outputPath), ec); // 输出没有发布，旁车文件不能留下
+        return PublishResult::Failed;
+    }
 
-        // B. 计算插值
-        RGB out = lut.apply(r, g, b);
+    published = generation;
+    return PublishResult::Published;
+}
 
-        // C. 写回像素 (反归一化 + 限制范围)
-        // 加 0.5f 是为了四舍五入
-        pixels[idx + 0] = static_cast<unsigned char>(std::clamp(out.r * 255.0f + 0.5f, 0.0f, 255.0f));
-        pixels[idx + 1] = static_cast<unsigned char>(std::clamp(out.g * 255.0f + 0.5f, 0.0f, 255.0f));
-        pixels[idx + 2] = static_cast<unsigned char>(std::clamp(out.b * 255.0f + 0.5f, 0.0f, 255.0f));
+// stats 非空时在应用 LUT 的同时收集质检统计
+// superseded 输出：结果比已发布的旧，被丢弃（不算失败，不需要重试）
+bool runPipeline(const std::string& sourcePath, const std::string& outputPath, int quality, const LutChain& luts,
+    unsigned long long generation, bool& superseded, ImageStats* stats = nullptr) {
+    superseded = false;
+    std::cout << "------------------------------------------------" << std::endl;
+    std::cout << ">>> 开始处理文件: " << sourcePath << std::endl;
+
+    ImageProcessor pixelProcessor;
+
+    if (!pixelProcessor.load(sourcePath)) {
+        std::cerr << "错误: 加载源图像失败: " << pixelProcessor.getLastError() << std::endl;
+        return false;
     }
+    std::cout << "尺寸: " << pixelProcessor.getWidth() << "x" << pixelProcessor.getHeight() << std::endl;
+    workerPool.yield(); // 阶段边界：有联机拍摄的图片在等，先把它做完
+
+    std::cout << "正在应用 LUT..." << std::endl;
+    applyLut(pixelProcessor, luts, stats);
+    workerPool.yield();
 
-    std::string tempPath = outputPath + ".tmp_lut_proc";
+    std::string tempPath = makeTempPath(outputPath);
 
     std::cout << "保存临时文件: " << tempPath << std::endl;
     if (!pixelProcessor.save(tempPath, quality)) {
         std::cerr << "错误: 保存临时文件失败: " << pixelProcessor.getLastError() << std::endl;
         return false;
     }
+    workerPool.yield();
 
     //元数据协调
     MetadataProcessor metaProcessor;
@@ -84,61 +306,356 @@ bool runPipeline(const std::string& sourcePath, const std::string& outputPath, i
         return false;
     }
 
-    //命名和清理
-    try {
-        fs::remove(outputPath); // 确保旧文件被删除
-        fs::rename(tempPath, outputPath); // 临时文件重命名为最终文件
-        std::cout << ">>> 成功处理并保存到: " << outputPath << std::endl;
-    }
-    catch (const fs::filesystem_error& e) {
-        std::cerr << "错误: 文件重命名/清理失败: " << e.what() << std::endl;
+    std::string sidecarTemp;
+    if (stats && !writeStatsSidecar(outputPath, *stats, sidecarTemp)) {
         fs::remove(tempPath);
         return false;
     }
 
+    //命名和清理
+    PublishResult result = publishOutput(tempPath, outputPath, sidecarTemp, generation);
+    if (result == PublishResult::Failed) return false;
+
+    superseded = result == PublishResult::Superseded;
+    if (!superseded) {
+        std::cout << ">>> 成功处理并保存到: " << outputPath << std::endl;
+    }
     return true;
 }
 
-// 回调函数
-void onFileChanged(const FileChangeEvent& event, void* userData) {
-    // 过滤掉非 JPG 文件
-    if (event.filePath.find(L".jpg") == std::string::npos &&
-        event.filePath.find(L".JPG") == std::string::npos) {
+// ---------------- 异步 I/O 模式（--async-io） ----------------
+// 磁盘读写全部交给 AsyncFileIO 的 I/O 线程批量完成，
+// 工作线程只做 解码 -> LUT -> 编码 -> 元数据注入，全程只和内存打交道。
+
+struct AsyncJob {
+    const RouteContext* route = nullptr;
+    std::string sourcePath;
+    std::string outputPath;
+    int retries = 3;
+    JobPriority priority = JobPriority::Batch;
+    int deadlineMs = 0; // 0 = 按优先级的默认值
+    unsigned long long generation = 0; // 入队时领取的世代号，见 publishOutput
+    std::vector<unsigned char> jpeg; // 读入的源文件内容
+};
+
+void processAsyncJob(AsyncJob& job);
+
+void submitAsyncRead(AsyncJob job, int delayMs) {
+    std::string sourcePath = job.sourcePath;
+    std::string outputPath = job.outputPath;
+    auto sharedJob = std::make_shared<AsyncJob>(std::move(job));
+
+    asyncIO.submitRead(sourcePath, [sharedJob](bool ok, std::vector<unsigned char>& data, const std::string& error) {
+        if (!ok) {
+            // 相机可能还占着文件、刚建出空文件或正在截断重写，和同步模式一样稍后重试
+            if (--sharedJob->retries > 0 && asyncIO.isRunning()) {
+                std::cout << "读取失败，等待 500ms 后重试: " << error << std::endl;
+                submitAsyncRead(std::move(*sharedJob), 500);
+                return;
+            }
+            std::cerr << "错误: 读取源文件失败: " << error << std::endl;
+            return;
+        }
+
+        // I/O 线程上只做入队，真正的处理交给该路由在线程池里的队列
+        sharedJob->jpeg = std::move(data);
+        workerPool.submit(sharedJob->route->queueId, [sharedJob]() {
+            processAsyncJob(*sharedJob);
+            }, sharedJob->priority, sharedJob->deadlineMs);
+        }, delayMs,
+        // 和同步模式在 load 之前 markStarted 一样：文件一旦打开，之后的改写要触发新任务，
+        // 否则读到的是旧版本、最终版本的事件却被当作“已在排队”丢掉
+        [outputPath]() { markStarted(outputPath); });
+}
+
+// 异步模式下工作线程复用的一组处理器
+struct AsyncProcessors {
+    ImageProcessor pixel;
+    MetadataProcessor meta;
+};
+
+void processAsyncJob(AsyncJob& job) {
+    // 句柄在每个工作线程内复用，避免每张图都重新初始化 TurboJPEG。
+    // 插队的交互任务会在阶段边界嵌套执行在同一线程上（见 WorkerPool::yield），每层各用一组
+    thread_local std::vector<std::unique_ptr<AsyncProcessors>> processorSets;
+    thread_local size_t depth = 0;
+    if (depth == processorSets.size()) processorSets.push_back(std::make_unique<AsyncProcessors>());
+    AsyncProcessors& processors = *processorSets[depth++];
+    struct DepthGuard { size_t& depth; ~DepthGuard() { --depth; } } depthGuard{ depth };
+    ImageProcessor& pixelProcessor = processors.pixel;
+    MetadataProcessor& metaProcessor = processors.meta;
+
+    std::cout << ">>> 开始处理文件: " << job.sourcePath << std::endl;
+
+    if (!pixelProcessor.loadFromMemory(job.jpeg.data(), job.jpeg.size())) {
+        // 多半是相机还没写完，稍后重新读一次
+        asyncIO.releaseBuffer(std::move(job.jpeg));
+        if (--job.retries > 0 && asyncIO.isRunning()) {
+            std::cout << "处理失败，等待 500ms 后重试..." << std::endl;
+            submitAsyncRead(std::move(job), 500);
+        }
+        else {
+            std::cerr << "错误: 解码源图像失败: " << pixelProcessor.getLastError() << std::endl;
+        }
+        return;
+    }
+    workerPool.yield(); // 阶段边界：有联机拍摄的图片在等，先把它做完
+
+    // 任务开始时取一次整条链，处理过程中 LUT 被替换也不受影响
+    LutChain luts;
+    std::vector<uint64_t> lutVersions;
+    if (!lutCache.getChain(job.route->route.lutChain, luts, &lutVersions)) {
+        std::cerr << "错误: " << lutCache.getLastError() << std::endl;
+        asyncIO.releaseBuffer(std::move(job.jpeg));
+        return;
+    }
+
+    std::unique_ptr<ImageStats> stats;
+    if (collectStats) stats = std::make_unique<ImageStats>();
+    applyLut(pixelProcessor, luts, stats.get());
+    workerPool.yield();
+
+    std::vector<unsigned char> output = asyncIO.acquireBuffer(0);
+    if (!pixelProcessor.saveToMemory(output, job.route->route.quality)) {
+        std::cerr << "错误: 编码失败: " << pixelProcessor.getLastError() << std::endl;
+        asyncIO.releaseBuffer(std::move(job.jpeg));
+        asyncIO.releaseBuffer(std::move(output));
         return;
     }
+    workerPool.yield();
+
+    if (!metaProcessor.copyMetadata(job.jpeg, output)) {
+        std::cerr << "错误: 元数据复制失败: " << metaProcessor.getLastError() << std::endl;
+        asyncIO.releaseBuffer(std::move(job.jpeg));
+        asyncIO.releaseBuffer(std::move(output));
+        return;
+    }
+    asyncIO.releaseBuffer(std::move(job.jpeg));
+
+    // 先写临时文件，写完后在 I/O 线程上改名，保证输出目录里不出现半截文件
+    std::string tempPath = makeTempPath(job.outputPath);
+    std::string outputPath = job.outputPath;
+    std::string sourcePath = job.sourcePath;
+    const RouteContext* route = job.route;
+    unsigned long long generation = job.generation;
+    auto writeOutput = [tempPath, outputPath, sourcePath, route, lutVersions, generation](std::vector<unsigned char> output, std::string sidecarTemp) {
+        asyncIO.submitWrite(tempPath, std::move(output), [tempPath, outputPath, sourcePath, route, lutVersions, generation, sidecarTemp](bool ok, std::vector<unsigned char>& data, const std::string& error) {
+            asyncIO.releaseBuffer(std::move(data));
+
+            if (!ok) {
+                std::cerr << "错误: 写入临时文件失败: " << error << std::endl;
+                std::error_code ec;
+                fs::remove(tempPath, ec);
+                if (!sidecarTemp.empty()) fs::remove(sidecarTemp, ec);
+                return;
+            }
+
+            if (publishOutput(tempPath, outputPath, sidecarTemp, generation) != PublishResult::Published) return;
+            std::cout << ">>> 成功处理并保存到: " << outputPath << std::endl;
+            recordDelivered(route, sourcePath, outputPath, lutVersions);
+            });
+        };
+
+    if (!stats) {
+        writeOutput(std::move(output), std::string());
+        return;
+    }
+
+    // 有统计时先把旁车文件的临时文件写好，再写输出，最后由 publishOutput 依次改名到位
+    std::string json = stats->toJson();
+    std::string sidecarTemp = makeTempPath(statsSidecarPath(job.outputPath));
+    auto pendingOutput = std::make_shared<std::vector<unsigned char>>(std::move(output));
+    asyncIO.submitWrite(sidecarTemp, std::vector<unsigned char>(json.begin(), json.end()),
+        [sidecarTemp, pendingOutput, writeOutput](bool ok, std::vector<unsigned char>&, const std::string& error) {
+            if (!ok) {
+                std::cerr << "错误: 写入统计文件失败: " << error << std::endl;
+                std::error_code ec;
+                fs::remove(sidecarTemp, ec);
+                asyncIO.releaseBuffer(std::move(*pendingOutput));
+                return;
+            }
+            writeOutput(std::move(*pendingOutput), sidecarTemp);
+        });
+}
+
+// 同步模式下在工作线程上执行的任务
+void processJob(const RouteContext* route, const std::string& sourcePath, const std::string& outputPath, unsigned long long generation) {
+    markStarted(outputPath);
+
+    // 简单的重试机制：
+    int retries = 3;
+    while (retries > 0) {
+        // 任务开始时取一次整条链，处理过程中 LUT 被替换也不受影响
+        LutChain luts;
+        std::vector<uint64_t> lutVersions;
+        if (!lutCache.getChain(route->route.lutChain, luts, &lutVersions)) {
+            std::cerr << "错误: " << lutCache.getLastError() << std::endl;
+            return;
+        }
+
+        std::unique_ptr<ImageStats> stats;
+        if (collectStats) stats = std::make_unique<ImageStats>();
+        bool superseded = false;
+        if (runPipeline(sourcePath, outputPath, route->route.quality, luts, generation, superseded, stats.get())) {
+            if (!superseded) recordDelivered(route, sourcePath, outputPath, lutVersions);
+            break;
+        }
+        std::cout << "处理失败，等待 500ms 后重试..." << std::endl;
+        Sleep(500);
+        retries--;
+    }
+}
 
-    //处理增加和修改
-    if (event.action == FileAction::Added || event.action == FileAction::Modified) {
+// 回调函数：userData 是触发事件的那条路由
+void onFileChanged(const FileChangeEvent& event, void* userData) {
+    const RouteContext* route = static_cast<const RouteContext*>(userData);
+
+    //处理增加、修改，以及先写临时名再改名到位的文件
+    if (event.action == FileAction::Added || event.action == FileAction::Modified ||
+        event.action == FileAction::RenamedNew) {
         std::string sourcePath = wstringToString(event.filePath);
+        std::string fileName = fs::path(sourcePath).filename().string();
+
+        // 只处理该路由关心的文件
+        if (!RouteConfig::matches(route->route, fileName)) return;
 
         //忽略临时文件
         if (sourcePath.find(".tmp") != std::string::npos)  return;
 
+        std::string outputPath = (fs::path(route->route.outputDir) / fileName).string();
 
-        std::cout << "\n[检测到变动] 文件: " << sourcePath << std::endl;
+        std::cout << "\n[检测到变动] [" << route->route.name << "] 文件: " << sourcePath << std::endl;
+        enqueueJob(route, sourcePath, outputPath, route->route.priority);
+    }
+    //源文件被删除或移走：LUT 更新后不再需要重做它的输出
+    else if ((event.action == FileAction::Removed || event.action == FileAction::RenamedOld) &&
+        route->route.reprocessOnLutChange) {
+        std::string fileName = fs::path(wstringToString(event.filePath)).filename().string();
+        forgetDelivered((fs::path(route->route.outputDir) / fileName).string());
+    }
+}
 
-        // 定义输出路径（这里简单地在同目录下生成 result.jpg，或者你可以根据逻辑修改）
-        // 为了演示，我们把输出放到 testout 文件夹，并保持同名
-        std::string outputPath = "D:/S5/testout/" +
-            std::filesystem::path(sourcePath).filename().string();
+// 把一个文件按给定优先级交给线程池
+void enqueueJob(const RouteContext* route, const std::string& sourcePath, const std::string& outputPath, JobPriority priority) {
+    // 同一输出已经在排队：写入过程中的多次 Modified 事件合并成一次处理。
+    // 已排队的优先级更低时（例如只在后台排队的输出又来了新文件），不能让新文件跟着低优先级队列等，照常提交
+    unsigned long long generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        auto it = pendingOutputs.find(outputPath);
+        if (it != pendingOutputs.end() && it->second <= priority) return;
+        pendingOutputs[outputPath] = priority;
+        generation = ++generationCounter;
+    }
 
-        // 简单的重试机制：
-        int retries = 3;
-        while (retries > 0) {
-            if (runPipeline(sourcePath, outputPath, 90)) {
-                break;
-            }
-            std::cout << "处理失败，等待 500ms 后重试..." << std::endl;
-            Sleep(500);
-            retries--;
-        }
+    // 路由的截止时间只对它自己的优先级有意义，后台重新处理用默认值
+    int deadlineMs = priority == route->route.priority ? route->route.deadlineMs : 0;
+
+    if (asyncIO.isRunning()) {
+        AsyncJob job;
+        job.route = route;
+        job.sourcePath = sourcePath;
+        job.outputPath = outputPath;
+        job.priority = priority;
+        job.deadlineMs = deadlineMs;
+        job.generation = generation;
+        submitAsyncRead(std::move(job), 0);
+        return;
     }
+
+    workerPool.submit(route->queueId, [route, sourcePath, outputPath, generation]() {
+        processJob(route, sourcePath, outputPath, generation);
+        }, priority, deadlineMs);
 }
 
+// 把调度指标整体写到文件，先写临时文件再改名，采集端不会读到半截内容
+void writeSchedulerMetrics(const std::string& metricsPath) {
+    std::string tempPath = metricsPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file << workerPool.getMetrics().toJson();
+    }
+    std::error_code ec;
+    fs::rename(tempPath, metricsPath, ec);
+}
 
+// LUT 目录的回调：只转交给 LutCache，去抖和解析都在它的后台线程上完成
+void onLutFileChanged(const FileChangeEvent& event, void* userData) {
+    if (event.action == FileAction::Added || event.action == FileAction::Modified ||
+        event.action == FileAction::RenamedNew) {
+        lutCache.requestReload(fs::path(event.filePath)); // 直接用宽字符路径，不经 ANSI 代码页转换
+    }
+}
 
-int main()
+// 精度校验模式：LutApplicator --verify-luts [a.cube ...] [--max-error=x] [--mean-error=x]
+//                                [--max-de=x] [--mean-de=x] [--max-code-diff=n]
+// 在合成 LUT 和给定的真实 LUT 上对比所有内核与双精度参考实现，有任何一项超阈值则返回 1
+int runLutVerification(int argc, char* argv[]) {
+    LutVerifier verifier;
+    AccuracyThresholds thresholds;
+    std::vector<std::string> lutPaths;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const std::string& prefix) {
+            return std::stod(arg.substr(prefix.size()));
+            };
+
+        try {
+            if (arg.rfind("--max-error=", 0) == 0) thresholds.maxError = value("--max-error=");
+            else if (arg.rfind("--mean-error=", 0) == 0) thresholds.meanError = value("--mean-error=");
+            else if (arg.rfind("--max-de=", 0) == 0) thresholds.maxDeltaE = value("--max-de=");
+            else if (arg.rfind("--mean-de=", 0) == 0) thresholds.meanDeltaE = value("--mean-de=");
+            else if (arg.rfind("--max-code-diff=", 0) == 0) thresholds.maxCodeDiff = static_cast<int>(value("--max-code-diff="));
+            else lutPaths.push_back(arg);
+        }
+        catch (const std::exception&) {
+            std::cerr << "错误: 无效的参数: " << arg << std::endl;
+            return 2;
+        }
+    }
+    verifier.setThresholds(thresholds);
+
+    // 先确认两种参考实现本身可信：仿射 LUT 上它们必须一致
+    double referenceDiff = LutVerifier::checkReferences();
+    bool referencesAgree = referenceDiff <= 1e-12;
+    std::cout << (referencesAgree ? "[通过] " : "[失败] ")
+        << "参考实现自检 三线 vs 四面体  maxDiff=" << referenceDiff << std::endl;
+    if (!referencesAgree) return 1;
+
+    std::vector<std::pair<std::string, Lut3D>> luts = LutVerifier::makeSyntheticLuts();
+    for (const std::string& path : lutPaths) {
+        Lut3D lut;
+        if (!lut.load(path)) {
+            std::cerr << "错误: LUT 加载失败: " << path << std::endl;
+            return 1;
+        }
+        luts.emplace_back(fs::path(path).filename().string(), lut);
+    }
+
+    bool allPassed = true;
+    for (const auto& [name, lut] : luts) {
+        for (const AccuracyReport& report : verifier.verify(name, lut)) {
+            std::cout << (report.passed ? "[通过] " : "[失败] ")
+                << report.lutName << " / " << report.kernelName
+                << "  maxErr=" << report.maxError
+                << " meanErr=" << report.meanError
+                << " maxΔE=" << report.maxDeltaE
+                << " meanΔE=" << report.meanDeltaE
+                << " maxCode=" << report.maxCodeDiff << std::endl;
+            allPassed = allPassed && report.passed;
+        }
+    }
+
+    return allPassed ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string(argv[1]) == "--verify-luts") {
+        return runLutVerification(argc, argv);
+    }
+
     std::thread thread1 = std::thread([&]() {
         for (int i = 0; i < 256; ++i) {
             toFloat[i] = static_cast<float>(i) / 255.0f;
@@ -148,20 +665,132 @@ int main()
     std::string source = "D:/S5/test/P1011157.jpg"; // 输入路径
     std::wstring watchDir = L"D:/S5/test";
 
-    FolderWatcher watcher;
-
     thread1.join();
 
-    if (watcher.start(watchDir, onFileChanged)) {
-        std::cout << "监听中... 按回车键退出。" << std::endl;
-        std::cin.get(); // 阻塞主线程，直到用户按回车
+    bool useAsyncIO = false;
+    int workerCount = 0;
+    int agingMs = -1;
+    std::string configPath;
+    std::string metricsPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--async-io") useAsyncIO = true;
+        else if (arg == "--stats") collectStats = true;
+        else if (arg.rfind("--config=", 0) == 0) configPath = arg.substr(9);
+        else if (arg.rfind("--workers=", 0) == 0) workerCount = std::atoi(arg.substr(10).c_str());
+        else if (arg.rfind("--aging-ms=", 0) == 0) agingMs = std::atoi(arg.substr(11).c_str());
+        else if (arg.rfind("--metrics=", 0) == 0) metricsPath = arg.substr(10);
+    }
 
-        watcher.stop();
+    // 路由表：有配置文件按配置来，否则退回原来的单目录行为
+    RouteConfig config;
+    if (!configPath.empty()) {
+        if (!config.load(configPath)) {
+            std::cerr << "错误: 路由配置加载失败: " << config.getLastError() << std::endl;
+            return 1;
+        }
+    }
+    else {
+        Route route;
+        route.name = "default";
+        route.watchDir = watchDir;
+        route.patterns = { "*.jpg" };
+        route.lutChain = { lutPath };
+        route.outputDir = "D:/S5/testout/";
+        config.addRoute(route);
+    }
+
+    // 启动时就把所有 LUT 载入缓存，配置错误立刻暴露
+    for (const Route& route : config.getRoutes()) {
+        LutChain luts;
+        std::cout << "正在加载 LUT: [" << route.name << "] " << route.lutChain.size() << " 个" << std::endl;
+        if (!lutCache.getChain(route.lutChain, luts)) {
+            std::cerr << "错误: " << lutCache.getLastError() << std::endl;
+            return 1;
+        }
+    }
+
+    if (useAsyncIO && !asyncIO.start()) {
+        std::cerr << "错误: 异步 I/O 启动失败" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<RouteContext>> routes;
+    for (const Route& route : config.getRoutes()) {
+        auto context = std::make_unique<RouteContext>();
+        context->route = route;
+        context->queueId = workerPool.addQueue(route.maxConcurrency);
+        context->lutKeys = LutCache::normalizeChain(route.lutChain);
+        routes.push_back(std::move(context));
+    }
+    if (agingMs >= 0) workerPool.setAging(agingMs);
+    workerPool.start(workerCount);
+
+    // --metrics=<文件>：每 5 秒导出一次各优先级的队列深度和等待时间
+    std::atomic<bool> metricsStopping{ false };
+    std::thread metricsThread;
+    if (!metricsPath.empty()) {
+        metricsThread = std::thread([&]() {
+            while (!metricsStopping) {
+                for (int i = 0; i < 50 && !metricsStopping; ++i) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+                writeSchedulerMetrics(metricsPath);
+            }
+            });
+    }
+
+    // 监听所有 LUT 所在目录，调色师改了 .cube 不用重启
+    lutCache.startReloader(onLutReloaded);
+    std::set<std::wstring> lutDirs;
+    for (const Route& route : config.getRoutes()) {
+        for (const std::string& lut : route.lutChain) {
+            lutDirs.insert(fs::absolute(fs::path(lut)).parent_path().wstring());
+        }
+    }
+    std::vector<std::unique_ptr<FolderWatcher>> lutWatchers;
+    for (const std::wstring& dir : lutDirs) {
+        auto watcher = std::make_unique<FolderWatcher>();
+        if (watcher->start(dir, onLutFileChanged)) {
+            lutWatchers.push_back(std::move(watcher));
+        }
+        else {
+            std::cerr << "警告: 无法监听 LUT 目录，热更新不可用: " << fs::path(dir).string() << std::endl;
+        }
+    }
+
+    int watching = 0;
+    for (auto& context : routes) {
+        if (context->watcher.start(context->route.watchDir, onFileChanged, context.get())) {
+            ++watching;
+        }
+        else {
+            std::cerr << "监听启动失败: [" << context->route.name << "]" << std::endl;
+        }
+    }
+
+    if (watching > 0) {
+        std::cout << "监听中（" << watching << " 个目录，" << workerPool.getThreadCount() << " 个工作线程）... 按回车键退出。" << std::endl;
+        std::cin.get(); // 阻塞主线程，直到用户按回车
     }
     else {
         std::cerr << "监听启动失败。" << std::endl;
     }
 
+    for (auto& context : routes) {
+        context->watcher.stop();
+    }
+    for (auto& watcher : lutWatchers) {
+        watcher->stop();
+    }
+    lutCache.stopReloader();
+    if (metricsThread.joinable()) {
+        metricsStopping = true;
+        metricsThread.join();
+    }
+    workerPool.stop();
+    asyncIO.stop(); // 工作线程退出后再停 I/O：读取取消，已提交的输出写完再返回
+
     return 0;
 
 }
@@ -0,0 +1,349 @@
+#include "AsyncFileIO.h"
+#include <windows.h>
+#include <filesystem>
+#include <algorithm>
+
+// һص I/O OVERLAPPED ǵһԱ¼ֱת Request
+struct AsyncFileIO::Request {
+    OVERLAPPED overlapped = {};
+    bool isWrite = false;
+    bool issued = false;
+    std::string filePath;
+    std::vector<unsigned char> data;
+    size_t offset = 0;
+    HANDLE file = INVALID_HANDLE_VALUE;
+    ReadCallback readCallback;
+    std::function<void()> beforeOpen;
+    WriteCallback writeCallback;
+    std::chrono::steady_clock::time_point notBefore;
+};
+
+namespace {
+    const DWORD kMaxChunk = 1u << 30; //  ReadFile/WriteFile 
+    const size_t kMaxPooledBuffers = 32;
+
+    std::string describeError(const std::string& what, const std::string& path, DWORD code) {
+        return what + ": " + path + " (error " + std::to_string(code) + ")";
+    }
+}
+
+AsyncFileIO::AsyncFileIO()
+    : m_port(NULL)
+    , m_running(false)
+    , m_maxInFlight(64)
+    , m_inFlight(0)
+    , m_ioExited(false)
+{
+}
+
+AsyncFileIO::~AsyncFileIO() {
+    stop();
+}
+
+bool AsyncFileIO::start(int maxInFlight) {
+    if (m_running) {
+        return false;
+    }
+
+    m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (m_port == NULL) {
+        return false;
+    }
+
+    m_maxInFlight = std::max(1, maxInFlight);
+    m_inFlight = 0;
+    m_ioExited = false;
+    m_running = true;
+    m_ioThread = std::thread(&AsyncFileIO::ioLoop, this);
+
+    return true;
+}
+
+void AsyncFileIO::stop() {
+    if (!m_running) return;
+
+    m_running = false;
+    wake();
+
+    if (m_ioThread.joinable()) {
+        m_ioThread.join();
+    }
+
+    CloseHandle(m_port);
+    m_port = NULL;
+}
+
+void AsyncFileIO::submitRead(const std::string& filePath, ReadCallback callback, int delayMs,
+    std::function<void()> beforeOpen) {
+    if (!m_running) {
+        // ֹͣٿʼµĶȡ
+        std::vector<unsigned char> empty;
+        if (callback) callback(false, empty, "I/O stopped: " + filePath);
+        return;
+    }
+
+    Request* request = new Request();
+    request->isWrite = false;
+    request->filePath = filePath;
+    request->readCallback = std::move(callback);
+    request->beforeOpen = std::move(beforeOpen);
+    request->notBefore = std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs);
+    enqueue(request);
+}
+
+void AsyncFileIO::submitWrite(const std::string& filePath, std::vector<unsigned char> data, WriteCallback callback) {
+    Request* request = new Request();
+    request->isWrite = true;
+    request->filePath = filePath;
+    request->data = std::move(data);
+    request->writeCallback = std::move(callback);
+    request->notBefore = std::chrono::steady_clock::now();
+    enqueue(request);
+}
+
+void AsyncFileIO::enqueue(Request* request) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_ioExited) {
+            m_pending.push_back(request);
+            request = nullptr;
+        }
+    }
+
+    if (request) {
+        complete(request, false, "I/O stopped: " + request->filePath);
+        return;
+    }
+    wake();
+}
+
+std::vector<unsigned char> AsyncFileIO::acquireBuffer(size_t size) {
+    std::vector<unsigned char> buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        // ȡһ㹻ģ resize ʱ·
+        auto it = std::find_if(m_bufferPool.begin(), m_bufferPool.end(),
+            [size](const std::vector<unsigned char>& b) { return b.capacity() >= size; });
+        if (it != m_bufferPool.end()) {
+            buffer = std::move(*it);
+            m_bufferPool.erase(it);
+        }
+    }
+
+    buffer.resize(size);
+    return buffer;
+}
+
+void AsyncFileIO::releaseBuffer(std::vector<unsigned char>&& buffer) {
+    if (buffer.capacity() == 0) return;
+
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    if (m_bufferPool.size() < kMaxPooledBuffers) {
+        buffer.clear();
+        m_bufferPool.push_back(std::move(buffer));
+    }
+}
+
+void AsyncFileIO::wake() {
+    if (m_port != NULL) {
+        PostQueuedCompletionStatus(m_port, 0, 0, NULL);
+    }
+}
+
+bool AsyncFileIO::issue(Request* request) {
+    std::wstring path = std::filesystem::path(request->filePath).wstring();
+
+    if (request->beforeOpen) {
+        request->beforeOpen();
+    }
+
+    if (request->isWrite) {
+        request->file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, NULL,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, NULL);
+    }
+    else {
+        // д뷽Գļʱϲʧܺ
+        request->file = CreateFileW(path.c_str(), GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    }
+
+    if (request->file == INVALID_HANDLE_VALUE) {
+        complete(request, false, describeError("Failed to open file", request->filePath, GetLastError()));
+        return false;
+    }
+
+    if (!request->isWrite) {
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(request->file, &fileSize)) {
+            complete(request, false, describeError("Failed to query file size", request->filePath, GetLastError()));
+            return false;
+        }
+        if (fileSize.QuadPart == 0) {
+            complete(request, false, "File is empty: " + request->filePath);
+            return false;
+        }
+        request->data = acquireBuffer(static_cast<size_t>(fileSize.QuadPart));
+    }
+
+    if (request->data.empty()) {
+        complete(request, true, "");
+        return false;
+    }
+
+    if (CreateIoCompletionPort(request->file, m_port, 0, 0) == NULL) {
+        complete(request, false, describeError("Failed to bind completion port", request->filePath, GetLastError()));
+        return false;
+    }
+
+    request->issued = true;
+    ++m_inFlight;
+    return issueNext(request);
+}
+
+bool AsyncFileIO::issueNext(Request* request) {
+    size_t remaining = request->data.size() - request->offset;
+    DWORD chunk = static_cast<DWORD>(std::min<size_t>(remaining, kMaxChunk));
+
+    request->overlapped = {};
+    request->overlapped.Offset = static_cast<DWORD>(request->offset & 0xFFFFFFFFull);
+    request->overlapped.OffsetHigh = static_cast<DWORD>(static_cast<unsigned long long>(request->offset) >> 32);
+
+    BOOL ok = request->isWrite
+        ? WriteFile(request->file, request->data.data() + request->offset, chunk, NULL, &request->overlapped)
+        : ReadFile(request->file, request->data.data() + request->offset, chunk, NULL, &request->overlapped);
+
+    if (!ok && GetLastError() != ERROR_IO_PENDING) {
+        complete(request, false, describeError(request->isWrite ? "Failed to write file" : "Failed to read file",
+            request->filePath, GetLastError()));
+        return false;
+    }
+
+    // ͬʱɶ˿Իյ֪ͨͳһ ioLoop ﴦ
+    return true;
+}
+
+void AsyncFileIO::complete(Request* request, bool ok, const std::string& error) {
+    if (request->file != INVALID_HANDLE_VALUE) {
+        CloseHandle(request->file);
+        request->file = INVALID_HANDLE_VALUE;
+    }
+    if (request->issued) {
+        --m_inFlight;
+    }
+
+    if (request->isWrite) {
+        if (request->writeCallback) request->writeCallback(ok, request->data, error);
+    }
+    else {
+        if (request->readCallback) request->readCallback(ok, request->data, error);
+    }
+
+    delete request;
+}
+
+void AsyncFileIO::ioLoop() {
+    const ULONG BATCH_SIZE = 64;
+    std::vector<OVERLAPPED_ENTRY> entries(BATCH_SIZE);
+    std::vector<Request*> active;
+    bool draining = false;
+
+    while (true) {
+        // 0. ֹͣȡ;ĶŶӵĶʧܣдճɣȫ̺˳
+        if (!m_running && !draining) {
+            draining = true;
+            for (Request* request : active) {
+                if (!request->isWrite) CancelIoEx(request->file, &request->overlapped);
+            }
+
+            std::vector<Request*> reads;
+            {
+                std::lock_guard<std::mutex> lock(m_queueMutex);
+                for (auto it = m_pending.begin(); it != m_pending.end();) {
+                    if (!(*it)->isWrite) {
+                        reads.push_back(*it);
+                        it = m_pending.erase(it);
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+            }
+            for (Request* request : reads) {
+                complete(request, false, "I/O stopped: " + request->filePath);
+            }
+        }
+
+        // 1. ;ھѵڵ󶼷ȥ豸б
+        DWORD timeout = INFINITE;
+        std::vector<Request*> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            if (draining && active.empty() && m_pending.empty()) {
+                m_ioExited = true;
+                break;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            for (auto it = m_pending.begin(); it != m_pending.end();) {
+                if ((*it)->notBefore <= now) {
+                    if (m_inFlight + static_cast<int>(ready.size()) >= m_maxInFlight) break;
+                    ready.push_back(*it);
+                    it = m_pending.erase(it);
+                }
+                else {
+                    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>((*it)->notBefore - now).count();
+                    timeout = std::min<DWORD>(timeout, static_cast<DWORD>(wait + 1));
+                    ++it;
+                }
+            }
+        }
+
+        for (Request* request : ready) {
+            if (issue(request)) {
+                active.push_back(request);
+            }
+        }
+        if (draining && active.empty()) {
+            continue; // շĶͬȥǷʣ
+        }
+
+        // 2. һո¼
+        ULONG removed = 0;
+        if (!GetQueuedCompletionStatusEx(m_port, entries.data(), BATCH_SIZE, &removed, timeout, FALSE)) {
+            continue; // ʱȥӳ
+        }
+
+        for (ULONG i = 0; i < removed; ++i) {
+            if (entries[i].lpOverlapped == NULL) {
+                continue; // wake() ĻѰ
+            }
+
+            Request* request = reinterpret_cast<Request*>(entries[i].lpOverlapped);
+            DWORD transferred = 0;
+            if (!GetOverlappedResult(request->file, &request->overlapped, &transferred, FALSE)) {
+                active.erase(std::find(active.begin(), active.end(), request));
+                complete(request, false, describeError(request->isWrite ? "Failed to write file" : "Failed to read file",
+                    request->filePath, GetLastError()));
+                continue;
+            }
+
+            request->offset += transferred;
+            if (transferred > 0 && request->offset < request->data.size()) {
+                if (!issueNext(request)) {
+                    active.erase(std::find(active.begin(), active.end(), request));
+                }
+                continue;
+            }
+
+            active.erase(std::find(active.begin(), active.end(), request));
+            if (request->offset < request->data.size()) {
+                // ļڶȡбض
+                complete(request, false, "Short read: " + request->filePath);
+            }
+            else {
+                complete(request, true, "");
+            }
+        }
+    }
+}
@@ -59,12 +59,24 @@ bool ImageProcessor::load(const std::string& filePath)
 
     file.close();
 
+    return loadFromMemory(jpegBuffer.data(), jpegBuffer.size());
+}
+
+bool ImageProcessor::loadFromMemory(const unsigned char* jpegData, size_t jpegSize)
+{
+    if (!m_decompressHandle) {
+        m_lastError = "Decompress handle is not initialized.";
+        return false;
+    }
+
+    cleanup();
+
     int width, height, subsamp, colorspace;
 
     // ȡȡͷȡͼߴ
     int result = tjDecompressHeader3(m_decompressHandle,
-        jpegBuffer.data(),
-        fileSize,
+        jpegData,
+        jpegSize,
         &width, &height, &subsamp, &colorspace);
     if (result != 0) {
         m_lastError = tj3GetErrorStr(m_decompressHandle);
@@ -83,8 +95,8 @@ bool ImageProcessor::load(const std::string& filePath)
     m_pixelData.reset(reinterpret_cast<unsigned char*>(tjAlloc(pixelSize)));
 
     result = tj3Decompress8(m_decompressHandle,
-        jpegBuffer.data(),
-        fileSize,
+        jpegData,
+        jpegSize,
         m_pixelData.get(),
         0, // pitch = 0 (Զ)
         TJPF_RGB); // ʽ
@@ -101,12 +113,8 @@ bool ImageProcessor::load(const std::string& filePath)
 
 bool ImageProcessor::save(const std::string& filePath, int quality)
 {
-    if (!m_compressHandle) {
-        m_lastError = "Compress handle is not initialized.";
-        return false;
-    }
-    if (!m_pixelData || m_width == 0 || m_height == 0) {
-        m_lastError = "No pixel data to save.";
+    std::vector<unsigned char> jpegBuffer;
+    if (!saveToMemory(jpegBuffer, quality)) {
         return false;
     }
 
@@ -116,6 +124,23 @@ bool ImageProcessor::save(const std::string& filePath, int quality)
         return false;
     }
 
+    file.write(reinterpret_cast<const char*>(jpegBuffer.data()), jpegBuffer.size());
+    file.close();
+
+    return true;
+}
+
+bool ImageProcessor::saveToMemory(std::vector<unsigned char>& output, int quality)
+{
+    if (!m_compressHandle) {
+        m_lastError = "Compress handle is not initialized.";
+        return false;
+    }
+    if (!m_pixelData || m_width == 0 || m_height == 0) {
+        m_lastError = "No pixel data to save.";
+        return false;
+    }
+
     unsigned char* compressedBuffer = nullptr; 
 	size_t jpegSize = 0;
 
@@ -131,14 +156,11 @@ bool ImageProcessor::save(const std::string& filePath, int quality)
 
     if (result != 0) {
         m_lastError = tj3GetErrorStr(m_compressHandle);
-        file.close();
         if (compressedBuffer) tjFree(compressedBuffer);
         return false;
     }
 
-    file.write(reinterpret_cast<const char*>(compressedBuffer), jpegSize);
-    file.close();
-
+    output.assign(compressedBuffer, compressedBuffer + jpegSize);
     tjFree(compressedBuffer);
 
     return true;
@@ -0,0 +1,97 @@
+#include "ImageStats.h"
+#include <sstream>
+
+void ImageStats::finalize() {
+    for (int c = 0; c < 3; ++c) {
+        clippedLowBefore[c] = histogramBefore[c][0];
+        clippedHighBefore[c] = histogramBefore[c][255];
+        clippedLowAfter[c] = histogramAfter[c][0];
+        clippedHighAfter[c] = histogramAfter[c][255];
+    }
+}
+
+double ImageStats::meanLumaBefore() const {
+    return pixelCount ? static_cast<double>(lumaSumBefore) / pixelCount : 0.0;
+}
+
+double ImageStats::meanLumaAfter() const {
+    return pixelCount ? static_cast<double>(lumaSumAfter) / pixelCount : 0.0;
+}
+
+int ImageStats::lumaPercentile(double percentile, bool after) const {
+    if (pixelCount == 0) return 0;
+
+    const uint64_t* histogram = after ? histogramAfter[LUMA] : histogramBefore[LUMA];
+    // һۼﵽĿֵ
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * pixelCount);
+    if (target == 0) target = 1;
+
+    uint64_t cumulative = 0;
+    for (int v = 0; v < 256; ++v) {
+        cumulative += histogram[v];
+        if (cumulative >= target) return v;
+    }
+    return 255;
+}
+
+namespace {
+    void writeArray(std::ostringstream& out, const uint64_t* values, int count) {
+        out << "[";
+        for (int i = 0; i < count; ++i) {
+            if (i) out << ",";
+            out << values[i];
+        }
+        out << "]";
+    }
+
+    // ռȣٷڿֱչʾ
+    void writePercent(std::ostringstream& out, const uint64_t* values, uint64_t pixelCount) {
+        out << "[";
+        for (int i = 0; i < 3; ++i) {
+            if (i) out << ",";
+            out << (pixelCount ? 100.0 * values[i] / pixelCount : 0.0);
+        }
+        out << "]";
+    }
+
+    void writeSide(std::ostringstream& out, const ImageStats& stats, bool after) {
+        const char* names[ImageStats::CHANNELS] = { "r", "g", "b", "luma" };
+        const auto& histogram = after ? stats.histogramAfter : stats.histogramBefore;
+
+        out << "{\"meanLuma\":" << (after ? stats.meanLumaAfter() : stats.meanLumaBefore());
+        out << ",\"lumaPercentiles\":{"
+            << "\"p1\":" << stats.lumaPercentile(1, after)
+            << ",\"p5\":" << stats.lumaPercentile(5, after)
+            << ",\"p50\":" << stats.lumaPercentile(50, after)
+            << ",\"p95\":" << stats.lumaPercentile(95, after)
+            << ",\"p99\":" << stats.lumaPercentile(99, after) << "}";
+
+        out << ",\"clippedLow\":";
+        writeArray(out, after ? stats.clippedLowAfter : stats.clippedLowBefore, 3);
+        out << ",\"clippedHigh\":";
+        writeArray(out, after ? stats.clippedHighAfter : stats.clippedHighBefore, 3);
+        out << ",\"clippedLowPercent\":";
+        writePercent(out, after ? stats.clippedLowAfter : stats.clippedLowBefore, stats.pixelCount);
+        out << ",\"clippedHighPercent\":";
+        writePercent(out, after ? stats.clippedHighAfter : stats.clippedHighBefore, stats.pixelCount);
+
+        out << ",\"histograms\":{";
+        for (int c = 0; c < ImageStats::CHANNELS; ++c) {
+            if (c) out << ",";
+            out << "\"" << names[c] << "\":";
+            writeArray(out, histogram[c], 256);
+        }
+        out << "}}";
+    }
+}
+
+std::string ImageStats::toJson() const {
+    std::ostringstream out;
+    out << "{\"pixelCount\":" << pixelCount;
+    out << ",\"before\":";
+    writeSide(out, *this, false);
+    out << ",\"after\":";
+    writeSide(out, *this, true);
+    out << "}";
+    return out.str();
+}
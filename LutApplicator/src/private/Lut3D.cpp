@@ -53,6 +53,15 @@ bool Lut3D::load(const std::string& filePath) {
     return m_size > 0 && m_table.size() == (m_size * m_size * m_size);
 }
 
+bool Lut3D::loadFromTable(int size, const std::vector<RGB>& table) {
+    if (size < 2 || table.size() != static_cast<size_t>(size) * size * size) {
+        return false;
+    }
+
+    m_size = size;
+    m_table = table;
+    return true;
+}
 
 // ֵ߲㷨
 RGB Lut3D::apply(float r, float g, float b) const {
@@ -0,0 +1,213 @@
+#include "LutCache.h"
+#include <filesystem>
+#include <iostream>
+
+LutCache::LutCache()
+    : m_nextVersion(1)
+    , m_debounceMs(300)
+    , m_reloadStopping(false)
+{
+}
+
+LutCache::~LutCache() {
+    stopReloader();
+}
+
+std::string LutCache::normalize(const std::filesystem::path& filePath) {
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::weakly_canonical(filePath, ec);
+    if (ec) {
+        path = filePath.lexically_normal();
+    }
+
+    // generic_string()  Windows ϰ ANSI ҳת޷ʾַ쳣
+    std::u8string key = path.generic_u8string();
+    return std::string(key.begin(), key.end());
+}
+
+std::vector<std::string> LutCache::normalizeChain(const std::vector<std::string>& filePaths) {
+    std::vector<std::string> keys;
+    for (const std::string& filePath : filePaths) {
+        keys.push_back(normalize(filePath));
+    }
+    return keys;
+}
+
+std::shared_ptr<const Lut3D> LutCache::get(const std::string& filePath, uint64_t* version) {
+    std::string key = normalize(filePath);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_luts.find(key);
+    if (it != m_luts.end()) {
+        if (version) *version = it->second.version;
+        return it->second.lut;
+    }
+
+    // ״μطڣͬһļ߳ͬʱʱҲֻһ
+    auto lut = std::make_shared<Lut3D>();
+    if (!lut->load(filePath)) {
+        m_lastError = "Failed to load LUT: " + filePath;
+        return nullptr;
+    }
+
+    Entry& entry = m_luts[key];
+    entry.filePath = filePath;
+    entry.lut = lut;
+    entry.version = m_nextVersion++;
+    if (version) *version = entry.version;
+    return lut;
+}
+
+bool LutCache::getChain(const std::vector<std::string>& filePaths, LutChain& chain, std::vector<uint64_t>* versions) {
+    chain.clear();
+    if (versions) versions->clear();
+
+    std::vector<std::string> keys = normalizeChain(filePaths);
+
+    // ȫѻʱͬһȡ֤õ¾ɻӵİ汾
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const std::string& key : keys) {
+            auto it = m_luts.find(key);
+            if (it == m_luts.end()) break;
+            chain.push_back(it->second.lut);
+            if (versions) versions->push_back(it->second.version);
+        }
+    }
+    if (chain.size() == filePaths.size()) {
+        return true;
+    }
+
+    chain.clear();
+    if (versions) versions->clear();
+    for (const std::string& filePath : filePaths) {
+        uint64_t version = 0;
+        std::shared_ptr<const Lut3D> lut = get(filePath, &version);
+        if (!lut) {
+            chain.clear();
+            if (versions) versions->clear();
+            return false;
+        }
+        chain.push_back(lut);
+        if (versions) versions->push_back(version);
+    }
+    return true;
+}
+
+bool LutCache::isStale(const std::vector<std::string>& keys, const std::vector<uint64_t>& versions) const {
+    if (keys.size() != versions.size()) return true;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto it = m_luts.find(keys[i]);
+        if (it != m_luts.end() && it->second.version != versions[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LutCache::startReloader(LutReloadedCallback callback, int debounceMs) {
+    if (m_reloadThread.joinable()) return;
+
+    m_onReloaded = std::move(callback);
+    m_debounceMs = debounceMs;
+    m_reloadStopping = false;
+    m_reloadThread = std::thread(&LutCache::reloadLoop, this);
+}
+
+void LutCache::stopReloader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_reloadStopping = true;
+    }
+    m_reloadCondition.notify_all();
+
+    if (m_reloadThread.joinable()) {
+        m_reloadThread.join();
+    }
+}
+
+void LutCache::requestReload(const std::filesystem::path& filePath) {
+    std::string key = normalize(filePath);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_luts.find(key) == m_luts.end()) return; // ûбκ·
+
+        // ÿα仯ˢʱ䣬д
+        m_dirty[key] = std::chrono::steady_clock::now();
+    }
+    m_reloadCondition.notify_all();
+}
+
+void LutCache::reloadLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_reloadStopping) {
+        if (m_dirty.empty()) {
+            m_reloadCondition.wait(lock);
+            continue;
+        }
+
+        // ҳѾ㹻õļ
+        auto now = std::chrono::steady_clock::now();
+        auto quiet = std::chrono::milliseconds(m_debounceMs);
+        auto nextCheck = now + quiet;
+        std::vector<std::string> ready;
+        for (auto it = m_dirty.begin(); it != m_dirty.end();) {
+            if (now - it->second >= quiet) {
+                ready.push_back(it->first);
+                it = m_dirty.erase(it);
+            }
+            else {
+                nextCheck = std::min(nextCheck, it->second + quiet);
+                ++it;
+            }
+        }
+
+        if (ready.empty()) {
+            m_reloadCondition.wait_until(lock, nextCheck);
+            continue;
+        }
+
+        // ߳ճӻȡɰ汾
+        lock.unlock();
+        for (const std::string& key : ready) {
+            uint64_t version = reload(key);
+            if (version != 0 && m_onReloaded) {
+                m_onReloaded(key, version);
+            }
+        }
+        lock.lock();
+    }
+}
+
+uint64_t LutCache::reload(const std::string& key) {
+    std::string filePath;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_luts.find(key);
+        if (it == m_luts.end()) return 0;
+        filePath = it->second.filePath;
+    }
+
+    auto lut = std::make_shared<Lut3D>();
+    if (!lut->load(filePath)) {
+        // ǻûд󣺱ɰ汾һα仯
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = "Failed to reload LUT, keeping previous version: " + filePath;
+        std::cerr << m_lastError << std::endl;
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_luts[key];
+    entry.lut = lut;
+    entry.version = m_nextVersion++;
+    return entry.version;
+}
+
+std::string LutCache::getLastError() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
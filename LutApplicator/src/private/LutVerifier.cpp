@@ -0,0 +1,376 @@
+#include "LutVerifier.h"
+#include <thread>
+#include <random>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// ˮͬοʵҲѳ [0,1] ضϺٱȽ
+inline double clamp01(double v) {
+    return std::clamp(v, 0.0, 1.0);
+}
+
+inline int toCode(double v) {
+    return static_cast<int>(std::clamp(v * 255.0 + 0.5, 0.0, 255.0));
+}
+
+// sRGB (D65) -> CIE Lab
+void srgbToLab(const double rgb[3], double lab[3]) {
+    double lin[3];
+    for (int i = 0; i < 3; ++i) {
+        double c = clamp01(rgb[i]);
+        lin[i] = (c <= 0.04045) ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+    }
+
+    double x = (0.4124564 * lin[0] + 0.3575761 * lin[1] + 0.1804375 * lin[2]) / 0.95047;
+    double y = (0.2126729 * lin[0] + 0.7151522 * lin[1] + 0.0721750 * lin[2]);
+    double z = (0.0193339 * lin[0] + 0.1191920 * lin[1] + 0.9503041 * lin[2]) / 1.08883;
+
+    auto f = [](double t) {
+        return (t > 216.0 / 24389.0) ? std::cbrt(t) : (24389.0 / 27.0 * t + 16.0) / 116.0;
+        };
+
+    double fx = f(x), fy = f(y), fz = f(z);
+    lab[0] = 116.0 * fy - 16.0;
+    lab[1] = 500.0 * (fx - fy);
+    lab[2] = 200.0 * (fy - fz);
+}
+
+// ȡ LUT 㣬˳ Lut3D::apply һ£R 죬B 
+inline const RGB& node(const Lut3D& lut, int r, int g, int b) {
+    int size = lut.getSize();
+    return lut.getTable()[r + g * size + b * size * size];
+}
+
+// ӳ䵽ռ䣬ڸӵ½ƫ
+inline void locate(const Lut3D& lut, double v, int& index, double& delta) {
+    double mapped = v * (lut.getSize() - 1);
+    index = std::clamp(static_cast<int>(mapped), 0, lut.getSize() - 2);
+    delta = mapped - index;
+}
+
+// ϳ LUTÿֵ
+template <typename Fn>
+Lut3D makeLut(int size, Fn fn) {
+    std::vector<RGB> table;
+    table.reserve(static_cast<size_t>(size) * size * size);
+    for (int b = 0; b < size; ++b) {
+        for (int g = 0; g < size; ++g) {
+            for (int r = 0; r < size; ++r) {
+                float fr = static_cast<float>(r) / (size - 1);
+                float fg = static_cast<float>(g) / (size - 1);
+                float fb = static_cast<float>(b) / (size - 1);
+                table.push_back(fn(fr, fg, fb));
+            }
+        }
+    }
+
+    Lut3D lut;
+    lut.loadFromTable(size, table);
+    return lut;
+}
+
+// ÿ̵߳ۼӽϲ
+struct ErrorAccumulator {
+    double maxError = 0.0;
+    double sumError = 0.0;
+    double maxDeltaE = 0.0;
+    double sumDeltaE = 0.0;
+    int maxCodeDiff = 0;
+};
+
+} // namespace
+
+LutVerifier::LutVerifier() {
+    addKernel("Lut3D::apply", LutInterpolation::Trilinear,
+        [](const Lut3D& lut, float r, float g, float b) { return lut.apply(r, g, b); });
+}
+
+void LutVerifier::addKernel(const std::string& name, LutInterpolation interpolation, LutKernel kernel) {
+    m_kernels.push_back({ name, interpolation, std::move(kernel) });
+}
+
+void LutVerifier::referenceTrilinear(const Lut3D& lut, double r, double g, double b, double out[3]) {
+    int ir, ig, ib;
+    double dr, dg, db;
+    locate(lut, r, ir, dr);
+    locate(lut, g, ig, dg);
+    locate(lut, b, ib, db);
+
+    // 8 Ȩֱչ lerp м
+    for (int c = 0; c < 3; ++c) {
+        auto at = [&](int x, int y, int z) {
+            const RGB& p = node(lut, ir + x, ig + y, ib + z);
+            return static_cast<double>(c == 0 ? p.r : (c == 1 ? p.g : p.b));
+            };
+
+        out[c] =
+            at(0, 0, 0) * (1 - dr) * (1 - dg) * (1 - db) +
+            at(1, 0, 0) * dr * (1 - dg) * (1 - db) +
+            at(0, 1, 0) * (1 - dr) * dg * (1 - db) +
+            at(1, 1, 0) * dr * dg * (1 - db) +
+            at(0, 0, 1) * (1 - dr) * (1 - dg) * db +
+            at(1, 0, 1) * dr * (1 - dg) * db +
+            at(0, 1, 1) * (1 - dr) * dg * db +
+            at(1, 1, 1) * dr * dg * db;
+    }
+}
+
+void LutVerifier::referenceTetrahedral(const Lut3D& lut, double r, double g, double b, double out[3]) {
+    int ir, ig, ib;
+    double dr, dg, db;
+    locate(lut, r, ir, dr);
+    locate(lut, g, ig, dg);
+    locate(lut, b, ib, db);
+
+    //  dr/dg/db ĴСϵѡ 6 ֮һ· 000 -> v1 -> v2 -> 111
+    int v1[3], v2[3];
+    double w0, w1, w2, w3;
+    if (dr >= dg && dg >= db) {
+        v1[0] = 1; v1[1] = 0; v1[2] = 0; v2[0] = 1; v2[1] = 1; v2[2] = 0;
+        w0 = 1 - dr; w1 = dr - dg; w2 = dg - db; w3 = db;
+    }
+    else if (dr >= db && db >= dg) {
+        v1[0] = 1; v1[1] = 0; v1[2] = 0; v2[0] = 1; v2[1] = 0; v2[2] = 1;
+        w0 = 1 - dr; w1 = dr - db; w2 = db - dg; w3 = dg;
+    }
+    else if (db >= dr && dr >= dg) {
+        v1[0] = 0; v1[1] = 0; v1[2] = 1; v2[0] = 1; v2[1] = 0; v2[2] = 1;
+        w0 = 1 - db; w1 = db - dr; w2 = dr - dg; w3 = dg;
+    }
+    else if (dg >= dr && dr >= db) {
+        v1[0] = 0; v1[1] = 1; v1[2] = 0; v2[0] = 1; v2[1] = 1; v2[2] = 0;
+        w0 = 1 - dg; w1 = dg - dr; w2 = dr - db; w3 = db;
+    }
+    else if (dg >= db && db >= dr) {
+        v1[0] = 0; v1[1] = 1; v1[2] = 0; v2[0] = 0; v2[1] = 1; v2[2] = 1;
+        w0 = 1 - dg; w1 = dg - db; w2 = db - dr; w3 = dr;
+    }
+    else {
+        v1[0] = 0; v1[1] = 0; v1[2] = 1; v2[0] = 0; v2[1] = 1; v2[2] = 1;
+        w0 = 1 - db; w1 = db - dg; w2 = dg - dr; w3 = dr;
+    }
+
+    const RGB& p0 = node(lut, ir, ig, ib);
+    const RGB& p1 = node(lut, ir + v1[0], ig + v1[1], ib + v1[2]);
+    const RGB& p2 = node(lut, ir + v2[0], ig + v2[1], ib + v2[2]);
+    const RGB& p3 = node(lut, ir + 1, ig + 1, ib + 1);
+
+    out[0] = w0 * p0.r + w1 * p1.r + w2 * p2.r + w3 * p3.r;
+    out[1] = w0 * p0.g + w1 * p1.g + w2 * p2.g + w3 * p3.g;
+    out[2] = w0 * p0.b + w1 * p1.b + w2 * p2.b + w3 * p3.b;
+}
+
+double LutVerifier::checkReferences() {
+    // ϵȡֵ 2 ݴηfloat 洢룬ֲֵ˫Ӧλһ
+    Lut3D lut = makeLut(5, [](float r, float g, float b) {
+        return RGB{ 0.5f * r + 0.25f * g + 0.125f * b,
+                    0.25f * r - 0.5f * g + 0.75f * b,
+                    -0.125f * r + 0.5f * g + 0.5f * b };
+        });
+
+    double maxDiff = 0.0;
+    for (int b = 0; b < 256; b += 5) {
+        for (int g = 0; g < 256; g += 5) {
+            for (int r = 0; r < 256; r += 5) {
+                double tri[3], tet[3];
+                referenceTrilinear(lut, r / 255.0, g / 255.0, b / 255.0, tri);
+                referenceTetrahedral(lut, r / 255.0, g / 255.0, b / 255.0, tet);
+                for (int c = 0; c < 3; ++c) {
+                    maxDiff = std::max(maxDiff, std::abs(tri[c] - tet[c]));
+                }
+            }
+        }
+    }
+
+    return maxDiff;
+}
+
+double LutVerifier::deltaE2000(const double rgb1[3], const double rgb2[3]) {
+    double lab1[3], lab2[3];
+    srgbToLab(rgb1, lab1);
+    srgbToLab(rgb2, lab2);
+
+    const double L1 = lab1[0], a1 = lab1[1], b1 = lab1[2];
+    const double L2 = lab2[0], a2 = lab2[1], b2 = lab2[2];
+
+    double C1 = std::sqrt(a1 * a1 + b1 * b1);
+    double C2 = std::sqrt(a2 * a2 + b2 * b2);
+    double Cbar = (C1 + C2) / 2.0;
+    double Cbar7 = std::pow(Cbar, 7.0);
+    double G = 0.5 * (1.0 - std::sqrt(Cbar7 / (Cbar7 + 6103515625.0))); // 25^7
+
+    double a1p = (1.0 + G) * a1;
+    double a2p = (1.0 + G) * a2;
+    double C1p = std::sqrt(a1p * a1p + b1 * b1);
+    double C2p = std::sqrt(a2p * a2p + b2 * b2);
+
+    auto hueAngle = [](double b, double a) {
+        if (a == 0.0 && b == 0.0) return 0.0;
+        double h = std::atan2(b, a) * 180.0 / kPi;
+        return h < 0.0 ? h + 360.0 : h;
+        };
+    double h1p = hueAngle(b1, a1p);
+    double h2p = hueAngle(b2, a2p);
+
+    double dLp = L2 - L1;
+    double dCp = C2p - C1p;
+
+    double dhp = 0.0;
+    if (C1p * C2p != 0.0) {
+        dhp = h2p - h1p;
+        if (dhp > 180.0) dhp -= 360.0;
+        else if (dhp < -180.0) dhp += 360.0;
+    }
+    double dHp = 2.0 * std::sqrt(C1p * C2p) * std::sin(dhp * kPi / 360.0);
+
+    double Lbarp = (L1 + L2) / 2.0;
+    double Cbarp = (C1p + C2p) / 2.0;
+
+    double hbarp = h1p + h2p;
+    if (C1p * C2p != 0.0) {
+        if (std::abs(h1p - h2p) <= 180.0) hbarp /= 2.0;
+        else if (h1p + h2p < 360.0) hbarp = (hbarp + 360.0) / 2.0;
+        else hbarp = (hbarp - 360.0) / 2.0;
+    }
+
+    double T = 1.0
+        - 0.17 * std::cos((hbarp - 30.0) * kPi / 180.0)
+        + 0.24 * std::cos((2.0 * hbarp) * kPi / 180.0)
+        + 0.32 * std::cos((3.0 * hbarp + 6.0) * kPi / 180.0)
+        - 0.20 * std::cos((4.0 * hbarp - 63.0) * kPi / 180.0);
+
+    double dTheta = 30.0 * std::exp(-((hbarp - 275.0) / 25.0) * ((hbarp - 275.0) / 25.0));
+    double Cbarp7 = std::pow(Cbarp, 7.0);
+    double Rc = 2.0 * std::sqrt(Cbarp7 / (Cbarp7 + 6103515625.0));
+    double Lm50 = (Lbarp - 50.0) * (Lbarp - 50.0);
+    double Sl = 1.0 + (0.015 * Lm50) / std::sqrt(20.0 + Lm50);
+    double Sc = 1.0 + 0.045 * Cbarp;
+    double Sh = 1.0 + 0.015 * Cbarp * T;
+    double Rt = -std::sin(2.0 * dTheta * kPi / 180.0) * Rc;
+
+    double tl = dLp / Sl;
+    double tc = dCp / Sc;
+    double th = dHp / Sh;
+    return std::sqrt(tl * tl + tc * tc + th * th + Rt * tc * th);
+}
+
+std::vector<AccuracyReport> LutVerifier::verify(const std::string& lutName, const Lut3D& lut) const {
+    std::vector<AccuracyReport> reports;
+    if (!lut.isValid()) return reports;
+
+    // ˮ toFloat һ£֤ں˿ȫͬ
+    float toFloatF[256];
+    for (int i = 0; i < 256; ++i) {
+        toFloatF[i] = static_cast<float>(i) / 255.0f;
+    }
+
+    const unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (const KernelEntry& entry : m_kernels) {
+        std::vector<ErrorAccumulator> partials(threadCount);
+        std::vector<std::thread> workers;
+
+        //  B Ƭָ̣߳ÿ̶߳ۼ
+        for (unsigned int t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&, t]() {
+                ErrorAccumulator& acc = partials[t];
+                for (int b = static_cast<int>(t); b < 256; b += static_cast<int>(threadCount)) {
+                    for (int g = 0; g < 256; ++g) {
+                        for (int r = 0; r < 256; ++r) {
+                            double ref[3];
+                            if (entry.interpolation == LutInterpolation::Tetrahedral) {
+                                referenceTetrahedral(lut, r / 255.0, g / 255.0, b / 255.0, ref);
+                            }
+                            else {
+                                referenceTrilinear(lut, r / 255.0, g / 255.0, b / 255.0, ref);
+                            }
+
+                            RGB out = entry.kernel(lut, toFloatF[r], toFloatF[g], toFloatF[b]);
+                            double got[3] = { out.r, out.g, out.b };
+
+                            for (int c = 0; c < 3; ++c) {
+                                double err = std::abs(got[c] - ref[c]);
+                                acc.maxError = std::max(acc.maxError, err);
+                                acc.sumError += err;
+                                acc.maxCodeDiff = std::max(acc.maxCodeDiff, std::abs(toCode(got[c]) - toCode(ref[c])));
+                            }
+
+                            double dE = deltaE2000(ref, got);
+                            acc.maxDeltaE = std::max(acc.maxDeltaE, dE);
+                            acc.sumDeltaE += dE;
+                        }
+                    }
+                }
+                });
+        }
+        for (std::thread& w : workers) {
+            w.join();
+        }
+
+        ErrorAccumulator total;
+        for (const ErrorAccumulator& acc : partials) {
+            total.maxError = std::max(total.maxError, acc.maxError);
+            total.sumError += acc.sumError;
+            total.maxDeltaE = std::max(total.maxDeltaE, acc.maxDeltaE);
+            total.sumDeltaE += acc.sumDeltaE;
+            total.maxCodeDiff = std::max(total.maxCodeDiff, acc.maxCodeDiff);
+        }
+
+        const double samples = 256.0 * 256.0 * 256.0;
+
+        AccuracyReport report;
+        report.lutName = lutName;
+        report.kernelName = entry.name;
+        report.maxError = total.maxError;
+        report.meanError = total.sumError / (samples * 3.0);
+        report.maxDeltaE = total.maxDeltaE;
+        report.meanDeltaE = total.sumDeltaE / samples;
+        report.maxCodeDiff = total.maxCodeDiff;
+        report.passed =
+            report.maxError <= m_thresholds.maxError &&
+            report.meanError <= m_thresholds.meanError &&
+            report.maxDeltaE <= m_thresholds.maxDeltaE &&
+            report.meanDeltaE <= m_thresholds.meanDeltaE &&
+            report.maxCodeDiff <= m_thresholds.maxCodeDiff;
+        reports.push_back(report);
+    }
+
+    return reports;
+}
+
+std::vector<std::pair<std::string, Lut3D>> LutVerifier::makeSyntheticLuts() {
+    std::vector<std::pair<std::string, Lut3D>> luts;
+
+    // ȣκں˶Ӧ
+    luts.emplace_back("identity-33", makeLut(33, [](float r, float g, float b) {
+        return RGB{ r, g, b };
+        }));
+
+    // Сߴ磬߽ӵض
+    luts.emplace_back("identity-2", makeLut(2, [](float r, float g, float b) {
+        return RGB{ r, g, b };
+        }));
+
+    // ǿԵ٤
+    luts.emplace_back("gamma-17", makeLut(17, [](float r, float g, float b) {
+        return RGB{ std::pow(r, 2.2f), std::pow(g, 2.2f), std::pow(b, 2.2f) };
+        }));
+
+    // ͨϣ [0,1] Ըǽض·
+    luts.emplace_back("cross-mix-65", makeLut(65, [](float r, float g, float b) {
+        return RGB{ 1.2f * r - 0.1f * g - 0.1f * b,
+                    0.2f * r + 0.9f * g - 0.1f * b,
+                    -0.1f * r + 0.3f * g + 1.1f * b };
+        }));
+
+    // ̶ӵŶģⲻĵɫ LUT
+    std::mt19937 rng(20240601u);
+    std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+    luts.emplace_back("noisy-33", makeLut(33, [&](float r, float g, float b) {
+        return RGB{ r + noise(rng), g + noise(rng), b + noise(rng) };
+        }));
+
+    return luts;
+}
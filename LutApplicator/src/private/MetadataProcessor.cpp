@@ -38,4 +38,44 @@ bool MetadataProcessor::copyMetadata(const std::string& sourcePath, const std::s
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+bool MetadataProcessor::copyMetadata(const std::vector<unsigned char>& sourceJpeg, std::vector<unsigned char>& destinationJpeg) {
+    m_lastError.clear();
+
+    try {
+        //ڴԭʼͼ
+        std::unique_ptr<Exiv2::Image> pSourceImage = Exiv2::ImageFactory::open(sourceJpeg.data(), sourceJpeg.size());
+        if (!pSourceImage) {
+            m_lastError = "Exiv2 ޷Դͼ";
+            return false;
+        }
+
+        //ڴĿͼMemIo Լĸ
+        std::unique_ptr<Exiv2::Image> pDestImage = Exiv2::ImageFactory::open(destinationJpeg.data(), destinationJpeg.size());
+        if (!pDestImage) {
+            m_lastError = "Exiv2 ޷Ŀͼ";
+            return false;
+        }
+
+        pSourceImage->readMetadata();
+        pDestImage->setExifData(pSourceImage->exifData());
+        pDestImage->writeMetadata();
+
+        //дԪݵͼ MemIo ػ
+        Exiv2::BasicIo& io = pDestImage->io();
+        if (io.open() != 0) {
+            m_lastError = "Exiv2 ޷ȡдԪݺͼ";
+            return false;
+        }
+        destinationJpeg.resize(io.size());
+        io.read(destinationJpeg.data(), destinationJpeg.size());
+        io.close();
+    }
+    catch (const Exiv2::Error& e) {
+        m_lastError = "Exiv2 ʱ: " + std::string(e.what());
+        return false;
+    }
+
+    return true;
+}
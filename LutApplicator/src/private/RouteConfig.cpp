@@ -0,0 +1,148 @@
+#include "RouteConfig.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+    std::string trim(const std::string& s) {
+        size_t begin = s.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) return std::string();
+        size_t end = s.find_last_not_of(" \t\r\n");
+        return s.substr(begin, end - begin + 1);
+    }
+
+    char lower(char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+}
+
+bool RouteConfig::load(const std::string& filePath) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        m_lastError = "Failed to open route config: " + filePath;
+        return false;
+    }
+
+    m_routes.clear();
+    m_lastError.clear();
+
+    Route current;
+    bool inRoute = false;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trim(line);
+
+        // עͺͿ
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+        // µһ = µһ·
+        if (line.front() == '[' && line.back() == ']') {
+            if (inRoute) {
+                if (!finishRoute(current)) return false;
+                m_routes.push_back(current);
+            }
+            current = Route();
+            current.name = trim(line.substr(1, line.size() - 2));
+            inRoute = true;
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (!inRoute || eq == std::string::npos) {
+            m_lastError = "Invalid line " + std::to_string(lineNumber) + " in " + filePath;
+            return false;
+        }
+
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+
+        if (key == "watch") current.watchDir = std::filesystem::path(value).wstring();
+        else if (key == "pattern") current.patterns.push_back(value);
+        else if (key == "lut") current.lutChain.push_back(value);
+        else if (key == "output") current.outputDir = value;
+        else if (key == "quality") current.quality = std::atoi(value.c_str());
+        else if (key == "concurrency") current.maxConcurrency = std::atoi(value.c_str());
+        else if (key == "reprocess") current.reprocessOnLutChange = (value == "true" || value == "1" || value == "yes");
+        else if (key == "priority") {
+            if (value == "interactive") current.priority = JobPriority::Interactive;
+            else if (value == "batch") current.priority = JobPriority::Batch;
+            else if (value == "background") current.priority = JobPriority::Background;
+            else {
+                m_lastError = "Unknown priority '" + value + "' at line " + std::to_string(lineNumber) + " in " + filePath;
+                return false;
+            }
+        }
+        else if (key == "deadline") current.deadlineMs = std::atoi(value.c_str());
+        else {
+            m_lastError = "Unknown key '" + key + "' at line " + std::to_string(lineNumber) + " in " + filePath;
+            return false;
+        }
+    }
+
+    if (inRoute) {
+        if (!finishRoute(current)) return false;
+        m_routes.push_back(current);
+    }
+
+    if (m_routes.empty()) {
+        m_lastError = "No routes defined in " + filePath;
+        return false;
+    }
+
+    return true;
+}
+
+bool RouteConfig::finishRoute(Route& route) {
+    if (route.watchDir.empty() || route.outputDir.empty() || route.lutChain.empty()) {
+        m_lastError = "Route [" + route.name + "] needs watch, lut and output";
+        return false;
+    }
+
+    if (route.patterns.empty()) {
+        route.patterns = { "*.jpg", "*.jpeg" };
+    }
+    route.quality = std::clamp(route.quality, 1, 100);
+    route.maxConcurrency = std::max(0, route.maxConcurrency);
+    route.deadlineMs = std::max(0, route.deadlineMs);
+
+    return true;
+}
+
+bool RouteConfig::matchGlob(const std::string& pattern, const std::string& fileName) {
+    // Ļƥ䣺¼һ * λãʧʱ˵һַ
+    size_t p = 0, f = 0;
+    size_t starP = std::string::npos, starF = 0;
+
+    while (f < fileName.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || lower(pattern[p]) == lower(fileName[f]))) {
+            ++p;
+            ++f;
+        }
+        else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starF = f;
+        }
+        else if (starP != std::string::npos) {
+            p = starP + 1;
+            f = ++starF;
+        }
+        else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+bool RouteConfig::matches(const Route& route, const std::string& fileName) {
+    for (const std::string& pattern : route.patterns) {
+        if (matchGlob(pattern, fileName)) return true;
+    }
+    return false;
+}
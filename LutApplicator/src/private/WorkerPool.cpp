@@ -0,0 +1,342 @@
+#include "WorkerPool.h"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+    // ǰִ߳еyield() ݴжܷ񱻴
+    thread_local const WorkerPool* t_pool = nullptr;
+    thread_local JobPriority t_priority = JobPriority::Interactive;
+
+    double percentile(std::vector<double> values, double p) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        size_t index = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+        return values[std::min(index, values.size() - 1)];
+    }
+}
+
+std::string SchedulerMetrics::toJson() const {
+    std::ostringstream out;
+    out << "{\"preemptions\":" << preemptions << ",\"classes\":{";
+    for (int c = 0; c < JobPriorityCount; ++c) {
+        const ClassMetrics& m = classes[c];
+        if (c > 0) out << ",";
+        out << "\"" << jobPriorityName(static_cast<JobPriority>(c)) << "\":{"
+            << "\"queued\":" << m.queued
+            << ",\"running\":" << m.running
+            << ",\"submitted\":" << m.submitted
+            << ",\"started\":" << m.started
+            << ",\"deadlineMisses\":" << m.deadlineMisses
+            << ",\"aged\":" << m.aged
+            << ",\"waitP50Ms\":" << m.waitP50Ms
+            << ",\"waitP95Ms\":" << m.waitP95Ms
+            << ",\"waitMaxMs\":" << m.waitMaxMs
+            << "}";
+    }
+    out << "}}";
+    return out.str();
+}
+
+WorkerPool::WorkerPool()
+    : m_nextQueue(0)
+    , m_backgroundRunning(0)
+    , m_busy(0)
+    , m_agingMs(5000)
+    , m_waitNext{}
+    , m_stopping(false)
+{
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+bool WorkerPool::start(int threadCount) {
+    if (!m_threads.empty()) {
+        return false; // Ѿ
+    }
+
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    m_stopping = false;
+    for (int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+
+    return true;
+}
+
+void WorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        for (Queue& queue : m_queues) {
+            for (auto& tasks : queue.tasks) {
+                tasks.clear();
+            }
+        }
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+}
+
+int WorkerPool::addQueue(int maxConcurrency) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Queue queue;
+    queue.maxConcurrency = std::max(0, maxConcurrency);
+    m_queues.push_back(std::move(queue));
+    return static_cast<int>(m_queues.size()) - 1;
+}
+
+void WorkerPool::setAging(int agingMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_agingMs = std::max(0, agingMs);
+}
+
+int WorkerPool::defaultDeadlineMs(JobPriority priority) {
+    switch (priority) {
+    case JobPriority::Interactive: return 1000;
+    case JobPriority::Batch:       return 60000;
+    default:                       return 0;
+    }
+}
+
+void WorkerPool::submit(int queueId, std::function<void()> task, JobPriority priority, int deadlineMs) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping || queueId < 0 || queueId >= static_cast<int>(m_queues.size())) return;
+
+        Task entry;
+        entry.run = std::move(task);
+        entry.priority = priority;
+        entry.enqueued = Clock::now();
+        if (deadlineMs <= 0) deadlineMs = defaultDeadlineMs(priority);
+        entry.deadline = deadlineMs > 0 ? entry.enqueued + std::chrono::milliseconds(deadlineMs) : Clock::time_point::max();
+
+        m_queues[queueId].tasks[static_cast<int>(priority)].push_back(std::move(entry));
+        ++m_metrics.classes[static_cast<int>(priority)].submitted;
+    }
+    m_condition.notify_one();
+}
+
+int WorkerPool::effectiveRank(const Task& task, Clock::time_point now) const {
+    const int cls = static_cast<int>(task.priority);
+    const int rank = cls * 2;
+    if (m_agingMs <= 0 || task.priority == JobPriority::Interactive) return rank;
+
+    // ÿ agingMs һ뼶̨ൽͣڽ֮
+    const int floor = task.priority == JobPriority::Background ? static_cast<int>(JobPriority::Batch) * 2 : 1;
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(now - task.enqueued).count();
+    long long aged = rank - 2 * (waited / m_agingMs);
+    return static_cast<int>(std::max<long long>(floor, aged));
+}
+
+bool WorkerPool::pickTask(bool interactiveOnly, int& queueId, JobPriority& priority) {
+    const size_t count = m_queues.size();
+    const Clock::time_point now = Clock::now();
+    // ̨ռ ߳-1 ֻ̣߳һ߳ʱͨŶӾͲʼ̨
+    const int threadCount = static_cast<int>(m_threads.size());
+    int backgroundLimit = threadCount - 1;
+    if (threadCount <= 1) {
+        bool normalQueued = false;
+        for (const Queue& queue : m_queues) {
+            if (!queue.tasks[static_cast<int>(JobPriority::Interactive)].empty() ||
+                !queue.tasks[static_cast<int>(JobPriority::Batch)].empty()) {
+                normalQueued = true;
+                break;
+            }
+        }
+        backgroundLimit = normalQueued ? 0 : 1;
+    }
+    const int classCount = interactiveOnly ? 1 : JobPriorityCount;
+
+    bool found = false;
+    int bestRank = 0;
+    int bestClass = 0;
+    bool bestOverdue = false;
+    Clock::time_point bestDeadline;
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = (m_nextQueue + i) % count;
+        Queue& queue = m_queues[index];
+        // ֻͨͨȲޣ̨̨ͬһ㣬Բ·ɵ
+        const bool normalFull = queue.maxConcurrency > 0 && queue.running - queue.backgroundRunning >= queue.maxConcurrency;
+        const bool backgroundFull = queue.maxConcurrency > 0 && queue.running >= queue.maxConcurrency;
+
+        // ڣЧȼ, ԭʼ, ֹʱ䣩еĺѡ
+        bool candidate = false;
+        int rank = 0;
+        int candidateClass = 0;
+        Clock::time_point deadline;
+        for (int c = 0; c < classCount; ++c) {
+            const std::deque<Task>& tasks = queue.tasks[c];
+            if (tasks.empty()) continue;
+            if (c == static_cast<int>(JobPriority::Background)) {
+                if (backgroundFull || m_backgroundRunning >= backgroundLimit) continue;
+            }
+            else if (normalFull) {
+                continue;
+            }
+
+            // ͬһͬһȽȳ׾Ǹ絽ڵ
+            const Task& head = tasks.front();
+            int headRank = effectiveRank(head, now);
+            // c ȼͬʱȱԭʼ
+            if (!candidate || headRank < rank) {
+                candidate = true;
+                rank = headRank;
+                deadline = head.deadline;
+                candidateClass = c;
+            }
+        }
+        if (!candidate) continue;
+
+        // ֮䣺ȱЧȼٱԭʼϻ񲻺ͱǸȣ
+        // ͬʱֻѾڵĽֹʱܲ嵽ǰ棨ԽԽȣ
+        // ת˳пǰĶУ·õ߳
+        bool overdue = deadline < now;
+        bool better = !found || rank < bestRank ||
+            (rank == bestRank && (candidateClass < bestClass ||
+                (candidateClass == bestClass && overdue && (!bestOverdue || deadline < bestDeadline))));
+        if (better) {
+            found = true;
+            bestRank = rank;
+            bestClass = candidateClass;
+            bestOverdue = overdue;
+            bestDeadline = deadline;
+            queueId = static_cast<int>(index);
+            priority = static_cast<JobPriority>(candidateClass);
+        }
+    }
+
+    if (found) {
+        // һδĶпʼң֤ת
+        m_nextQueue = (static_cast<size_t>(queueId) + 1) % count;
+    }
+    return found;
+}
+
+WorkerPool::Task WorkerPool::takeTask(int queueId, JobPriority priority, Clock::time_point now) {
+    const int c = static_cast<int>(priority);
+    std::deque<Task>& tasks = m_queues[queueId].tasks[c];
+    Task task = std::move(tasks.front());
+    tasks.pop_front();
+
+    ++m_queues[queueId].running;
+    if (priority == JobPriority::Background) {
+        ++m_queues[queueId].backgroundRunning;
+        ++m_backgroundRunning;
+    }
+
+    SchedulerMetrics::ClassMetrics& metrics = m_metrics.classes[c];
+    ++metrics.running;
+    ++metrics.started;
+    if (now > task.deadline) ++metrics.deadlineMisses;
+    if (effectiveRank(task, now) < c * 2) ++metrics.aged;
+
+    double waitMs = std::chrono::duration<double, std::milli>(now - task.enqueued).count();
+    std::vector<double>& samples = m_waitSamples[c];
+    if (samples.size() < WaitSampleCount) samples.push_back(waitMs);
+    else samples[m_waitNext[c]] = waitMs;
+    m_waitNext[c] = (m_waitNext[c] + 1) % WaitSampleCount;
+
+    return task;
+}
+
+void WorkerPool::runTask(Task& task, int queueId) {
+    t_pool = this;
+    t_priority = task.priority;
+
+    task.run();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_queues[queueId].running;
+        --m_metrics.classes[static_cast<int>(task.priority)].running;
+        if (task.priority == JobPriority::Background) {
+            --m_queues[queueId].backgroundRunning;
+            --m_backgroundRunning;
+        }
+    }
+    // ͷź󣬱޵סִܿ
+    m_condition.notify_all();
+}
+
+bool WorkerPool::yield() {
+    // ڱصߵǰѾǽ񣨲ӲǶף
+    if (t_pool != this || t_priority == JobPriority::Interactive) return false;
+
+    Task task;
+    int queueId = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return false;
+
+        // п߳ʱǣشϵǰ
+        if (m_busy < static_cast<int>(m_threads.size())) return false;
+
+        JobPriority priority;
+        if (!pickTask(true, queueId, priority)) return false;
+        task = takeTask(queueId, priority, Clock::now());
+        ++m_metrics.preemptions;
+    }
+
+    const JobPriority interrupted = t_priority;
+    runTask(task, queueId);
+    t_priority = interrupted;
+    return true;
+}
+
+SchedulerMetrics WorkerPool::getMetrics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SchedulerMetrics metrics = m_metrics;
+
+    for (int c = 0; c < JobPriorityCount; ++c) {
+        SchedulerMetrics::ClassMetrics& m = metrics.classes[c];
+        m.queued = 0;
+        for (const Queue& queue : m_queues) {
+            m.queued += queue.tasks[c].size();
+        }
+
+        const std::vector<double>& samples = m_waitSamples[c];
+        m.waitP50Ms = percentile(samples, 50.0);
+        m.waitP95Ms = percentile(samples, 95.0);
+        m.waitMaxMs = samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+    }
+
+    return metrics;
+}
+
+void WorkerPool::workerLoop() {
+    while (true) {
+        Task task;
+        int queueId = -1;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            JobPriority priority = JobPriority::Batch;
+            m_condition.wait(lock, [&] {
+                if (m_stopping) return true;
+                return pickTask(false, queueId, priority);
+                });
+            if (m_stopping) return;
+
+            task = takeTask(queueId, priority, Clock::now());
+            ++m_busy;
+        }
+
+        runTask(task, queueId);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busy;
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+typedef void* HANDLE;
+
+/**
+ * @brief ȡɻصok Ϊ false ʱ error ԭdata Ϊļȫ
+ * ע⣺ص I/O ִ߳УֻӦ֮
+ */
+typedef std::function<void(bool ok, std::vector<unsigned char>& data, const std::string& error)> ReadCallback;
+
+/**
+ * @brief дɻصdata ΪдĻɹ黹
+ */
+typedef std::function<void(bool ok, std::vector<unsigned char>& data, const std::string& error)> WriteCallback;
+
+/**
+ * @brief  I/O ɶ˿ڵ첽ļд
+ * д̲һ I/O ߳ϣص I/O ͬʱֶ;
+ * ֻ߳ڴ滺򽻵ڴϡ
+ */
+class AsyncFileIO {
+public:
+    AsyncFileIO();
+    ~AsyncFileIO();
+
+    /**
+     * @brief  I/O ߳
+     * @param maxInFlight ͬʱ;
+     */
+    bool start(int maxInFlight = 64);
+
+    /**
+     * @brief ֹͣ I/O ̣߳ٽµĶȡ;ŶӵĶȡʧܻص
+     * ύдȫɺŷأѾõᶪ
+     */
+    void stop();
+
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief ύļȡ
+     * @param filePath ļ·
+     * @param callback ɻص
+     * @param delayMs ӳٶٺٿʼԣȴд뷽
+     * @param beforeOpen ѡ I/O ߳ϴļ֮ǰã˺ļı仯ᷴӳζȡ
+     */
+    void submitRead(const std::string& filePath, ReadCallback callback, int delayMs = 0,
+        std::function<void()> beforeOpen = nullptr);
+
+    /**
+     * @brief ύļд루ļ
+     * @param filePath ļ·
+     * @param data дݣȨתƸ I/O ֱ߳ص
+     * @param callback ɻص
+     */
+    void submitWrite(const std::string& filePath, std::vector<unsigned char> data, WriteCallback callback);
+
+    /**
+     * @brief ӻȡһΪ size Ļÿͼ·
+     */
+    std::vector<unsigned char> acquireBuffer(size_t size);
+
+    /**
+     * @brief ѲʹõĻ
+     */
+    void releaseBuffer(std::vector<unsigned char>&& buffer);
+
+private:
+    struct Request;
+
+    /**
+     * @brief I/O ߳ѭո¼
+     */
+    void ioLoop();
+
+    /**
+     * @brief ļһص/д
+     */
+    bool issue(Request* request);
+
+    /**
+     * @brief ӵǰƫƼʣಿֵĶ/д
+     */
+    bool issueNext(Request* request);
+
+    /**
+     * @brief һ󲢵ûص
+     */
+    void complete(Request* request, bool ok, const std::string& error);
+
+    /**
+     * @brief ӣI/O ߳˳ʱֱʧܻص
+     */
+    void enqueue(Request* request);
+
+    /**
+     * @brief ɶ˿ϵ I/O ߳
+     */
+    void wake();
+
+private:
+    HANDLE m_port; // ɶ˿
+    std::thread m_ioThread;
+    std::atomic<bool> m_running;
+    int m_maxInFlight;
+    int m_inFlight; //  I/O ̷߳
+
+    std::mutex m_queueMutex;
+    std::deque<Request*> m_pending; // δ
+    bool m_ioExited; // I/O ߳˳֮ύֱʧܣ m_queueMutex 
+
+    std::mutex m_poolMutex;
+    std::vector<std::vector<unsigned char>> m_bufferPool;
+
+    AsyncFileIO(const AsyncFileIO&) = delete;
+    AsyncFileIO& operator=(const AsyncFileIO&) = delete;
+};
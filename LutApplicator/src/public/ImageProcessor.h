@@ -38,6 +38,20 @@ public:
      */
     bool save(const std::string& filePath, int quality = 90);
 
+    /**
+     * @brief ڴеJPGݽ루ʴ̣
+     * @param jpegData JPG
+     * @param jpegSize ݳ
+     */
+    bool loadFromMemory(const unsigned char* jpegData, size_t jpegSize);
+
+    /**
+     * @brief ͼΪJPGдڴ滺ʴ̣
+     * @param output ԭݱ
+     * @param quality ѹ
+     */
+    bool saveToMemory(std::vector<unsigned char>& output, int quality = 90);
+
     /**
      * @brief ȡͼݵġָ롱
      * ʽΪ [R, G, B, R, G, B, ...]
@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief ͼӦ LUT ǰʼͳ
+ * ֱͼ± 0-2 Ϊ R/G/B3 ΪȣRec.709 Ȩأ
+ */
+struct ImageStats {
+    static const int CHANNELS = 4;
+    static const int LUMA = 3;
+
+    uint64_t pixelCount = 0;
+
+    uint64_t histogramBefore[CHANNELS][256] = {};
+    uint64_t histogramAfter[CHANNELS][256] = {};
+
+    // ÿɫͨ 0ڣ 255أϵ
+    uint64_t clippedLowBefore[3] = {};
+    uint64_t clippedHighBefore[3] = {};
+    uint64_t clippedLowAfter[3] = {};
+    uint64_t clippedHighAfter[3] = {};
+
+    uint64_t lumaSumBefore = 0;
+    uint64_t lumaSumAfter = 0;
+
+    /**
+     * @brief 8 λȣֱͼʹͬһʽ
+     */
+    static inline int luma(int r, int g, int b) {
+        return (54 * r + 183 * g + 19 * b + 128) >> 8;
+    }
+
+    /**
+     * @brief ۼһأLUT ѭã
+     */
+    inline void add(int r0, int g0, int b0, int r1, int g1, int b1) {
+        ++pixelCount;
+
+        int y0 = luma(r0, g0, b0);
+        int y1 = luma(r1, g1, b1);
+
+        ++histogramBefore[0][r0]; ++histogramBefore[1][g0]; ++histogramBefore[2][b0]; ++histogramBefore[LUMA][y0];
+        ++histogramAfter[0][r1]; ++histogramAfter[1][g1]; ++histogramAfter[2][b1]; ++histogramAfter[LUMA][y1];
+
+        lumaSumBefore += y0;
+        lumaSumAfter += y1;
+    }
+
+    /**
+     * @brief ֱͼѭжϣ
+     */
+    void finalize();
+
+    double meanLumaBefore() const;
+    double meanLumaAfter() const;
+
+    /**
+     * @brief Ȱٷλ
+     * @param percentile 0-100
+     * @param after true ȡ LUT ֮ȣfalse ȡ֮ǰ
+     */
+    int lumaPercentile(double percentile, bool after) const;
+
+    /**
+     * @brief лΪ JSON
+     */
+    std::string toJson() const;
+};
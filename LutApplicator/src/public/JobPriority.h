@@ -0,0 +1,18 @@
+#pragma once
+
+// ȼֵԽСԽ
+enum class JobPriority {
+    Interactive = 0, // 㣺ͻĻȣҪ뼶
+    Batch = 1,       // 
+    Background = 2   // LUT º´
+};
+
+const int JobPriorityCount = 3;
+
+inline const char* jobPriorityName(JobPriority priority) {
+    switch (priority) {
+    case JobPriority::Interactive: return "interactive";
+    case JobPriority::Batch:       return "batch";
+    default:                       return "background";
+    }
+}
@@ -14,10 +14,20 @@ public:
 
     bool load(const std::string& filePath);
 
+    /**
+     * @brief ֱڴеı LUTںϳɲ LUT
+     * @param size ÿĸ
+     * @param table  R 졢B е size^3 ɫ
+     */
+    bool loadFromTable(int size, const std::vector<RGB>& table);
+
     RGB apply(float r, float g, float b) const;
 
     bool isValid() const { return m_size > 0 && !m_table.empty(); }
 
+    int getSize() const { return m_size; }
+    const std::vector<RGB>& getTable() const { return m_table; }
+
 private:
     int m_size; // LUT ĳߴ
     std::vector<RGB> m_table; // 洢еɫ
@@ -0,0 +1,120 @@
+#pragma once
+#include "Lut3D.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <unordered_map>
+#include <filesystem>
+
+/**
+ * @brief ˳Ӧõһ LUT
+ */
+typedef std::vector<std::shared_ptr<const Lut3D>> LutChain;
+
+/**
+ * @brief LUT ¼ɵ֪ͨ
+ * @param filePath 仯 .cube ļnormalize õĻ
+ * @param version °汾
+ */
+typedef std::function<void(const std::string& filePath, uint64_t version)> LutReloadedCallback;
+
+/**
+ * @brief ڹ LUT 棺ͬһ .cube ۱·ãֻֻռһڴ
+ * ֧ȸ£ļ仯ں̨߳½ɹ滻
+ * ڿʼʱȡ shared_ptr滻ӰڴͼƬ
+ */
+class LutCache {
+public:
+    LutCache();
+    ~LutCache();
+
+    /**
+     * @brief ȡһ LUT״ηʱӴ̼
+     * @param filePath .cube ļ·
+     * @param version ѡ LUT ǰİ汾
+     * @return ʧܷؿָ
+     */
+    std::shared_ptr<const Lut3D> get(const std::string& filePath, uint64_t* version = nullptr);
+
+    /**
+     * @brief ȡ LUT 
+     * @param filePaths Ӧ˳е .cube ļ
+     * @param chain 
+     * @param versions ѡÿ LUT İ汾
+     */
+    bool getChain(const std::vector<std::string>& filePaths, LutChain& chain, std::vector<uint64_t>* versions = nullptr);
+
+    /**
+     * @brief ĳ汾ɵĽǷѾʱһ LUT ѱ¼أ
+     * @param keys  normalizeChain 淶 LUT ÷ÿζļϵͳ
+     * @param versions ɽʱ getChain İ汾
+     */
+    bool isStale(const std::vector<std::string>& keys, const std::vector<uint64_t>& versions) const;
+
+    /**
+     * @brief ̨¼߳
+     * @param callback ÿ滻ɹãں̨߳ϣ
+     * @param debounceMs ļһα仯ȴٽܿ༭ֶд
+     */
+    void startReloader(LutReloadedCallback callback, int debounceMs = 300);
+
+    /**
+     * @brief ֹ̨ͣ¼߳
+     */
+    void stopReloader();
+
+    /**
+     * @brief ֪ͨĳ LUT ļ˱仯ʵʽں̨߳Ͻ
+     */
+    void requestReload(const std::filesystem::path& filePath);
+
+    /**
+     * @brief 淶·ΪUTF-8ʹͬдͬһļͬһ
+     *  path խַ߳ϵĿַ· ANSI ҳת
+     */
+    static std::string normalize(const std::filesystem::path& filePath);
+
+    /**
+     * @brief 淶 LUT 
+     */
+    static std::vector<std::string> normalizeChain(const std::vector<std::string>& filePaths);
+
+    std::string getLastError() const;
+
+private:
+    struct Entry {
+        std::string filePath;
+        std::shared_ptr<const Lut3D> lut;
+        uint64_t version = 0;
+    };
+
+    /**
+     * @brief ̨̣߳ȥ½滻
+     */
+    void reloadLoop();
+
+    /**
+     * @brief ½һ LUTɹ滻°汾ţʧܷ 0 ɰ汾
+     */
+    uint64_t reload(const std::string& key);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_luts;
+    uint64_t m_nextVersion;
+    std::string m_lastError;
+
+    std::thread m_reloadThread;
+    std::condition_variable m_reloadCondition;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_dirty; // ¼صļ -> һα仯ʱ
+    LutReloadedCallback m_onReloaded;
+    int m_debounceMs;
+    bool m_reloadStopping;
+
+    LutCache(const LutCache&) = delete;
+    LutCache& operator=(const LutCache&) = delete;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include "Lut3D.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+/**
+ * @brief οʵʹõĲֵʽ
+ */
+enum class LutInterpolation {
+    Trilinear,   // ֵ߲
+    Tetrahedral  // ֵ
+};
+
+/**
+ * @brief УĲֵںˣһ RGB LUT 
+ */
+typedef std::function<RGB(const Lut3D& lut, float r, float g, float b)> LutKernel;
+
+/**
+ * @brief жֵͨ 0.0-1.0 һλƣ
+ */
+struct AccuracyThresholds {
+    double maxError = 1e-4;     // ͨ
+    double meanError = 1e-5;    // ͨƽ
+    double maxDeltaE = 0.5;     //  E2000
+    double meanDeltaE = 0.05;   // ƽ E2000
+    int maxCodeDiff = 1;        //  8 λֵ
+};
+
+/**
+ * @brief  LUT ϵں˵У
+ */
+struct AccuracyReport {
+    std::string lutName;
+    std::string kernelName;
+    double maxError = 0.0;
+    double meanError = 0.0;
+    double maxDeltaE = 0.0;
+    double meanDeltaE = 0.0;
+    int maxCodeDiff = 0;
+    bool passed = false;
+};
+
+/**
+ * @brief ƽ׼У飺 RGB8 壨256^3 룩ϣ
+ *        ˫ȲοֵԱÿעŻںˡ
+ */
+class LutVerifier {
+public:
+    /**
+     * @brief ʱԶעںˣLut3D::apply
+     */
+    LutVerifier();
+
+    /**
+     * @brief עһҪУں
+     * @param name ʾ
+     * @param interpolation ںʵֵĲֵʽյĲοʵ
+     * @param kernel ں˺
+     */
+    void addKernel(const std::string& name, LutInterpolation interpolation, LutKernel kernel);
+
+    void setThresholds(const AccuracyThresholds& thresholds) { m_thresholds = thresholds; }
+    const AccuracyThresholds& getThresholds() const { return m_thresholds; }
+
+    /**
+     * @brief һ LUT Уעں
+     * @param lutName ʾ LUT 
+     * @param lut У LUT
+     * @return ÿںһݱ
+     */
+    std::vector<AccuracyReport> verify(const std::string& lutName, const Lut3D& lut) const;
+
+    /**
+     * @brief һϳ LUTȡ٤ͨϡŶǳ뼫״
+     */
+    static std::vector<std::pair<std::string, Lut3D>> makeSyntheticLuts();
+
+    /**
+     * @brief ˫Ȳοֵ߲
+     */
+    static void referenceTrilinear(const Lut3D& lut, double r, double g, double b, double out[3]);
+
+    /**
+     * @brief ˫Ȳοֵ
+     */
+    static void referenceTetrahedral(const Lut3D& lut, double r, double g, double b, double out[3]);
+
+    /**
+     * @brief οʵԼ죺ڷ LUT ֵȷָ÷亯߱һ
+     * @return ֲοֵ֮Բ
+     */
+    static double checkReferences();
+
+    /**
+     * @brief  sRGB ɫ0.0-1.0֮ E2000
+     */
+    static double deltaE2000(const double rgb1[3], const double rgb2[3]);
+
+private:
+    struct KernelEntry {
+        std::string name;
+        LutInterpolation interpolation;
+        LutKernel kernel;
+    };
+
+    std::vector<KernelEntry> m_kernels;
+    AccuracyThresholds m_thresholds;
+};
@@ -2,6 +2,7 @@
 
 
 #include <string>
+#include <vector>
 
 /**
  * @brief רŸͼļ֮临ԪݣEXIF, IPTC, XMPȣࡣ
@@ -19,6 +20,14 @@ public:
      */
     bool copyMetadata(const std::string& sourcePath, const std::string& destinationPath);
 
+    /**
+     * @brief ڴаԴJPGԪݸƵĿJPGʴ̡
+     * @param sourceJpeg ԭʼͼݡ
+     * @param destinationJpeg עԪݵͼݣɹ滻ΪԪݵİ汾
+     * @return ɹ trueʧܷ false
+     */
+    bool copyMetadata(const std::vector<unsigned char>& sourceJpeg, std::vector<unsigned char>& destinationJpeg);
+
     /**
      * @brief ȡһβĴϢ
      */
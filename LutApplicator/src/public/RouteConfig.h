@@ -0,0 +1,77 @@
+#pragma once
+#include "JobPriority.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief һ·ɣĸļСЩļĴ LUTô롢
+ */
+struct Route {
+    std::string name;
+    std::wstring watchDir;
+    std::vector<std::string> patterns;  // ļͨ *.jpgִСд
+    std::vector<std::string> lutChain;  // ˳Ӧõ LUT ļ
+    std::string outputDir;
+    int quality = 90;
+    int maxConcurrency = 0;             // ·ͬʱռõ߳0 = 
+    bool reprocessOnLutChange = false;  // LUT ºǷں̨´ѾͼƬ
+    JobPriority priority = JobPriority::Batch; // Ŀ¼Ϊ interactive
+    int deadlineMs = 0;                 // Ӽ⵽ļĽֹʱ䣬0 = ȼĬֵ
+};
+
+/**
+ * @brief ·ɱãINI ÿ [] һ·ɣ
+ *
+ *   [client-a]
+ *   watch = D:/S5/test
+ *   pattern = *.jpg
+ *   lut = D:/S5/luts/base.cube
+ *   lut = D:/S5/luts/client-a.cube
+ *   output = D:/S5/testout/
+ *   quality = 90
+ *   concurrency = 2
+ *   reprocess = true
+ *   priority = interactive
+ *   deadline = 800
+ *
+ * pattern  lut ظ֣δд pattern ʱĬ *.jpg  *.jpeg
+ * priority ѡ interactive / batch / backgroundĬ batch
+ */
+class RouteConfig {
+public:
+    RouteConfig() = default;
+
+    /**
+     * @brief ļȡ·ɱ
+     * @param filePath ļ·
+     */
+    bool load(const std::string& filePath);
+
+    /**
+     * @brief ֱһ·ɣûļʱĬ·ɣ
+     */
+    void addRoute(const Route& route) { m_routes.push_back(route); }
+
+    const std::vector<Route>& getRoutes() const { return m_routes; }
+
+    std::string getLastError() const { return m_lastError; }
+
+    /**
+     * @brief ͨƥ䣬֧ *  ?ִСд
+     */
+    static bool matchGlob(const std::string& pattern, const std::string& fileName);
+
+    /**
+     * @brief ļǷƥ·ɵһ pattern
+     */
+    static bool matches(const Route& route, const std::string& fileName);
+
+private:
+    /**
+     * @brief У鲢ȫһս·
+     */
+    bool finishRoute(Route& route);
+
+    std::vector<Route> m_routes;
+    std::string m_lastError;
+};
@@ -0,0 +1,167 @@
+#pragma once
+#include "JobPriority.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * @brief ָ
+ */
+struct SchedulerMetrics {
+    struct ClassMetrics {
+        size_t queued = 0;           // ǰŶȣ
+        int running = 0;             // ִ
+        uint64_t submitted = 0;      // ۼύ
+        uint64_t started = 0;        // ۼƿʼִ
+        uint64_t deadlineMisses = 0; // ʼִʱѳֹʱ
+        uint64_t aged = 0;           // ȴñŵõִ
+        double waitP50Ms = 0.0;      // Ŷӵȴʱ
+        double waitP95Ms = 0.0;
+        double waitMaxMs = 0.0;
+    };
+
+    ClassMetrics classes[JobPriorityCount];
+    uint64_t preemptions = 0; // ڽ׶αִ߽еĽ
+
+    std::string toJson() const;
+};
+
+/**
+ * @brief ·ɹĹ̳߳أֹʱȼ
+ * ÿ·һУÿȼͽֹʱ䡣ڰ
+ * Чȼ, ԭʼ, ֹʱ䣩ȡ񣻶֮ȱЧȼԭʼ
+ * ͬʱתƽȣֻѾڵĽֹʱԽת˳
+ * ͬʱÿԼĲޣһͻռкģ
+ * ̨ռͨб̨ռʱµͼƬܿʼ
+ * ϻÿŶ agingMs Чȼһѹ񲻻ᱻ
+ * ̨ͣڽ֮£ϻ֮Ⱥ
+ * ռڽ׶α߽ yield()нڵûп̣߳
+ * ڵǰ߳Ȱټ
+ * ̨ռ ߳-1 ̣߳ʼոµͼƬһ̣߳
+ * ֻһ߳ʱֻ̨ûͨŶʱʼ
+ */
+class WorkerPool {
+public:
+    WorkerPool();
+    ~WorkerPool();
+
+    /**
+     * @brief ߳
+     * @param threadCount ߳0 = Ӳ߳
+     */
+    bool start(int threadCount = 0);
+
+    /**
+     * @brief ֹͣδʼ񣬵ȴִе
+     */
+    void stop();
+
+    /**
+     * @brief ½һУһһ·һ
+     * @param maxConcurrency öͬʱִе0 = 
+     * @return б
+     */
+    int addQueue(int maxConcurrency = 0);
+
+    /**
+     * @brief ϻ
+     * @param agingMs ÿŶôãЧһ0 = ϻ
+     */
+    void setAging(int agingMs);
+
+    /**
+     * @brief ָύ
+     * @param priority ȼ
+     * @param deadlineMs ύĽֹʱ䣬0 = Ĭֵ
+     */
+    void submit(int queueId, std::function<void()> task, JobPriority priority = JobPriority::Batch, int deadlineMs = 0);
+
+    /**
+     * @brief ׶α߽ó㣬ֻڹִ߳е
+     * ǰǽнڵûп߳ʱ͵ִһ
+     * @return Ƿִ˲
+     */
+    bool yield();
+
+    /**
+     * @brief ȡõǰĵָ
+     */
+    SchedulerMetrics getMetrics();
+
+    int getThreadCount() const { return static_cast<int>(m_threads.size()); }
+
+    /**
+     * @brief ĬϽֹʱ䣨룩̨ûнֹʱ
+     */
+    static int defaultDeadlineMs(JobPriority priority);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Task {
+        std::function<void()> run;
+        JobPriority priority = JobPriority::Batch;
+        Clock::time_point enqueued;
+        Clock::time_point deadline;
+    };
+
+    struct Queue {
+        std::deque<Task> tasks[JobPriorityCount]; // ֿͬȽȳ
+        int running = 0;
+        int backgroundRunning = 0; // running еĺ̨
+        int maxConcurrency = 0;
+    };
+
+    /**
+     * @brief ߳ѭ
+     */
+    void workerLoop();
+
+    /**
+     * @brief ŶеǰЧȼϻԽСԽ
+     * ԰뼶Ϊλ c ϻʱΪ 2c 1̨ 2
+     */
+    int effectiveRank(const Task& task, Clock::time_point now) const;
+
+    /**
+     * @brief жһҪִе
+     * @param interactiveOnly ֻǽ yield
+     * @param queueId ڶ
+     * @param priority 
+     * @return Ƿҵ
+     */
+    bool pickTask(bool interactiveOnly, int& queueId, JobPriority& priority);
+
+    /**
+     * @brief ȡѡе񲢼ˣ
+     */
+    Task takeTask(int queueId, JobPriority priority, Clock::time_point now);
+
+    /**
+     * @brief ִһȡ񣬽ͷŲ
+     */
+    void runTask(Task& task, int queueId);
+
+private:
+    std::vector<Queue> m_queues;
+    size_t m_nextQueue; // ת
+    int m_backgroundRunning; // ִеĺ̨
+    int m_busy; // ִִ߳вռ̣߳
+    int m_agingMs;
+
+    // ָ
+    static const size_t WaitSampleCount = 1024;
+    SchedulerMetrics m_metrics;
+    std::vector<double> m_waitSamples[JobPriorityCount]; // λ壬Ŷӵȴʱ
+    size_t m_waitNext[JobPriorityCount];
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+};
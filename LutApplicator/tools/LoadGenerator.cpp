@@ -0,0 +1,633 @@
+﻿// LoadGenerator.cpp: 合成负载生成器与 SLO 浸泡测试。
+//
+// 不接相机也能复现现场的突发写入：按设定的速率和突发形状向监听目录写入 JPG，
+// 包括分段写入、先写临时名再改名、对同一文件快速重写，
+// 同时监听输出目录，统计 到达 -> 输出 的延迟分位数、丢失和重复处理。
+// 每次写入的内容都不同；--verify（自包含模式下默认开启，路由须为恒等 LUT）时
+// 解码每个输出，只有由最后写入的版本生成的输出才算交付。
+//
+// 用法一：对已经在运行的 LutApplicator 施压（路由配置指向同一组目录）
+//   LutLoadGen --watch=D:/S5/test --out=D:/S5/testout --count=500 --shape=burst
+//              --burst=50 --burst-gap-ms=2000 --partial=0.2 --rename=0.2 --rewrite=0.1
+//              --slo-p99-ms=3000 --slo-min-throughput=5
+// 用法二：自包含的浸泡测试（CTest 的 watch_soak 用的就是这种）
+//   LutLoadGen --launch=<LutApplicator.exe> [--launch-args="--async-io"] [--work=lut_soak] ...
+//   在工作目录里生成恒等 LUT 和路由配置，启动被测程序，施压结束后发回车让它正常退出。
+//   尺寸用 --size 调小（如 640x480），结果就不太依赖机器的核数。
+// 任何一项 SLO 不达标、或被测程序没有正常退出，返回 1，可直接作为发布门禁。
+
+#include "FolderWatcher.h"
+#include <turbojpeg.h>
+#include <windows.h>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdlib>
+#include <cmath>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// 负载参数
+struct LoadOptions {
+    std::string watchDir;
+    std::string outputDir;
+    int count = 200;             // 生成的文件数
+    std::string shape = "steady"; // steady: 匀速；burst: 成批写入；ramp: 速率线性上升
+    double rate = 10.0;          // steady/ramp 的目标速率（文件/秒），ramp 时为终点速率
+    int burstSize = 50;          // burst 时每批的文件数
+    int burstGapMs = 2000;       // burst 时批与批之间的间隔
+    double partialRatio = 0.0;   // 分两段写入、中间停顿的比例
+    double renameRatio = 0.0;    // 先写 .part 再改名的比例
+    double rewriteRatio = 0.0;   // 写完后立即再重写同一文件的比例
+    int rewriteTimes = 3;        // 每个重写文件被写入的次数
+    int width = 4000;
+    int height = 3000;
+    int timeoutMs = 60000;       // 最后一个文件写完后，等待输出的最长时间
+    unsigned int seed = 12345;
+    double sloP99Ms = 0.0;       // 0 = 不检查
+    double sloMinThroughput = 0.0;
+    int maxDropped = 0;
+    int maxDuplicates = -1;      // -1 = 不检查
+    bool cleanup = false;
+    bool verifyContent = false;  // 解码输出，核对是否由最后写入的版本生成
+    std::string launchPath;      // 非空时自行启动被测的 LutApplicator
+    std::string launchArgs;      // 附加给被测程序的参数
+    std::string workDir = "lut_soak"; // 自包含模式的工作目录
+    int launchWaitMs = 2000;     // 启动后等待它开始监听的时间
+};
+
+// 单个输入文件的记录
+struct InputRecord {
+    std::string fileName;
+    Clock::time_point arrival; // 最后一次写入完成（文件完整可见）的时刻
+    int sample = -1;           // 最后一次写入所用的样张
+    bool arrived = false;
+};
+
+// 内容指纹：在 16x16 网格上取样的 RGB，用来判断一张输出是由哪个样张生成的
+typedef std::vector<unsigned char> Fingerprint;
+
+// 一次交付
+struct Delivery {
+    Clock::time_point time;
+    int sample = -1; // 输出内容对应的样张，-1 = 未核对或无法识别
+};
+
+// 输出目录里看到的交付事件
+struct OutputTracker {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::vector<Delivery>> deliveries; // 文件名 -> 每次交付
+    const std::vector<Fingerprint>* fingerprints = nullptr; // 非空时核对每次交付的内容
+};
+
+Fingerprint fingerprint(const unsigned char* pixels, int width, int height) {
+    const int grid = 16;
+    Fingerprint result;
+    result.reserve(grid * grid * 3);
+    for (int gy = 0; gy < grid; ++gy) {
+        for (int gx = 0; gx < grid; ++gx) {
+            int x = (2 * gx + 1) * width / (2 * grid);
+            int y = (2 * gy + 1) * height / (2 * grid);
+            const unsigned char* p = pixels + (static_cast<size_t>(y) * width + x) * 3;
+            result.insert(result.end(), p, p + 3);
+        }
+    }
+    return result;
+}
+
+// 读取整个文件；允许对方同时改名覆盖它，避免核对内容时挡住被测程序发布新的输出
+bool readFileShared(const fs::path& path, std::vector<unsigned char>& data) {
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size = {};
+    bool ok = GetFileSizeEx(file, &size) && size.QuadPart > 0;
+    if (ok) {
+        data.resize(static_cast<size_t>(size.QuadPart));
+        DWORD read = 0;
+        ok = ReadFile(file, data.data(), static_cast<DWORD>(data.size()), &read, NULL) && read == data.size();
+    }
+    CloseHandle(file);
+    return ok;
+}
+
+// 解码输出文件，找出内容最接近的样张；读不到、解码失败或和哪个都不像时返回 -1
+int identifySample(const fs::path& path, const std::vector<Fingerprint>& fingerprints) {
+    std::vector<unsigned char> jpeg;
+    if (!readFileShared(path, jpeg)) return -1;
+
+    tjhandle handle = tjInitDecompress();
+    if (!handle) return -1;
+
+    int width = 0, height = 0, subsamp = 0, colorspace = 0;
+    std::vector<unsigned char> pixels;
+    bool ok = tjDecompressHeader3(handle, jpeg.data(), static_cast<unsigned long>(jpeg.size()), &width, &height, &subsamp, &colorspace) == 0;
+    if (ok) {
+        pixels.resize(static_cast<size_t>(width) * height * 3);
+        ok = tj3Decompress8(handle, jpeg.data(), jpeg.size(), pixels.data(), 0, TJPF_RGB) == 0;
+    }
+    tjDestroy(handle);
+    if (!ok) return -1;
+
+    // 恒等 LUT 下输出只差两次 JPEG 编码的误差，不同样张之间的差距要大得多
+    Fingerprint actual = fingerprint(pixels.data(), width, height);
+    int best = -1;
+    double bestDiff = 16.0;
+    for (size_t v = 0; v < fingerprints.size(); ++v) {
+        double diff = 0.0;
+        for (size_t k = 0; k < actual.size(); ++k) {
+            diff += std::abs(static_cast<int>(actual[k]) - static_cast<int>(fingerprints[v][k]));
+        }
+        diff /= actual.size();
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            best = static_cast<int>(v);
+        }
+    }
+    return best;
+}
+
+// 宽字符文件名转窄字符（与生成时的纯 ASCII 文件名比较即可）
+std::string narrow(const std::wstring& wstr) {
+    return fs::path(wstr).string();
+}
+
+// 输出目录的回调：只记录最终文件名上的新建/改名事件，忽略临时文件与统计文件
+void onOutputChanged(const FileChangeEvent& event, void* userData) {
+    OutputTracker* tracker = static_cast<OutputTracker*>(userData);
+
+    if (event.action != FileAction::Added && event.action != FileAction::RenamedNew) return;
+
+    std::string fileName = narrow(fs::path(event.filePath).filename().wstring());
+    if (fileName.find(".tmp") != std::string::npos) return;
+    if (fileName.size() < 4 || fileName.substr(fileName.size() - 4) != ".jpg") return;
+
+    Delivery delivery;
+    delivery.time = Clock::now();
+    if (tracker->fingerprints) {
+        // 立即核对：再晚一点文件就可能被下一次输出覆盖
+        delivery.sample = identifySample(fs::path(event.filePath), *tracker->fingerprints);
+    }
+
+    std::lock_guard<std::mutex> lock(tracker->mutex);
+    tracker->deliveries[fileName].push_back(delivery);
+}
+
+// 生成若干张内容不同的合成 JPG，写入时循环使用；fingerprints 收到每张的内容指纹
+std::vector<std::vector<unsigned char>> makeSampleJpegs(int width, int height, int variants, std::vector<Fingerprint>& fingerprints) {
+    std::vector<std::vector<unsigned char>> samples;
+    tjhandle handle = tjInitCompress();
+    if (!handle) return samples;
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 3);
+    for (int v = 0; v < variants; ++v) {
+        // 渐变 + 按变体平移，保证每张图的编码结果不同
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                size_t idx = (static_cast<size_t>(y) * width + x) * 3;
+                pixels[idx + 0] = static_cast<unsigned char>((x * 255 / width + v * 37) & 0xFF);
+                pixels[idx + 1] = static_cast<unsigned char>((y * 255 / height + v * 71) & 0xFF);
+                pixels[idx + 2] = static_cast<unsigned char>(((x + y) * 255 / (width + height) + v * 113) & 0xFF);
+            }
+        }
+
+        unsigned char* jpeg = nullptr;
+        size_t jpegSize = 0;
+        tj3Set(handle, TJPARAM_QUALITY, 90);
+        tj3Set(handle, TJPARAM_SUBSAMP, TJSAMP_420);
+        if (tj3Compress8(handle, pixels.data(), width, 0, height, TJPF_RGB, &jpeg, &jpegSize) == 0) {
+            samples.emplace_back(jpeg, jpeg + jpegSize);
+            fingerprints.push_back(fingerprint(pixels.data(), width, height));
+        }
+        if (jpeg) tjFree(jpeg);
+    }
+
+    tjDestroy(handle);
+    return samples;
+}
+
+// 按负载形状计算第 i 个文件相对开始时刻的写入时间
+Clock::duration scheduleOffset(const LoadOptions& options, int i) {
+    using namespace std::chrono;
+
+    if (options.shape == "burst") {
+        int batch = i / std::max(1, options.burstSize);
+        return milliseconds(static_cast<long long>(batch) * options.burstGapMs);
+    }
+    if (options.shape == "ramp") {
+        // 速率在 T = 2 * count / rate 内从 0 线性升到 rate，第 i 个文件出现在 t = sqrt(2 * i * T / rate)
+        double rate = std::max(0.001, options.rate);
+        double total = 2.0 * options.count / rate;
+        return duration_cast<Clock::duration>(duration<double>(std::sqrt(2.0 * i * total / rate)));
+    }
+    return duration_cast<Clock::duration>(duration<double>(i / std::max(0.001, options.rate)));
+}
+
+// 写一个文件；返回文件完整可见的时刻
+Clock::time_point writeInput(const LoadOptions& options, const std::string& fileName,
+    const std::vector<unsigned char>& data, bool partial, bool rename) {
+    fs::path finalPath = fs::path(options.watchDir) / fileName;
+    fs::path writePath = rename ? fs::path(finalPath.string() + ".part") : finalPath;
+
+    {
+        std::ofstream file(writePath, std::ios::binary | std::ios::trunc);
+        if (partial) {
+            // 模拟读卡器慢速拷贝：先写一半，停一下再写完
+            size_t half = data.size() / 2;
+            file.write(reinterpret_cast<const char*>(data.data()), half);
+            file.flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            file.write(reinterpret_cast<const char*>(data.data()) + half, data.size() - half);
+        }
+        else {
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+    }
+
+    if (rename) {
+        std::error_code ec;
+        fs::rename(writePath, finalPath, ec);
+    }
+
+    return Clock::now();
+}
+
+// 自包含模式：在工作目录里准备输入/输出目录、2^3 恒等 LUT 和一条路由的配置
+bool prepareSoakRoute(LoadOptions& options, std::string& configPath) {
+    std::error_code ec;
+    fs::path work = fs::absolute(options.workDir);
+    if (options.watchDir.empty()) options.watchDir = (work / "in").string();
+    if (options.outputDir.empty()) options.outputDir = (work / "out").string();
+    fs::create_directories(options.watchDir, ec);
+    fs::create_directories(options.outputDir, ec);
+
+    fs::path lutPath = work / "soak_identity.cube";
+    {
+        std::ofstream cube(lutPath);
+        cube << "LUT_3D_SIZE 2\n";
+        for (int b = 0; b < 2; ++b) {
+            for (int g = 0; g < 2; ++g) {
+                for (int r = 0; r < 2; ++r) {
+                    cube << r << " " << g << " " << b << "\n";
+                }
+            }
+        }
+        if (!cube) return false;
+    }
+
+    fs::path iniPath = work / "soak.ini";
+    {
+        std::ofstream ini(iniPath);
+        ini << "[soak]\n"
+            << "watch = " << fs::path(options.watchDir).generic_string() << "\n"
+            << "pattern = *.jpg\n"
+            << "lut = " << lutPath.generic_string() << "\n"
+            << "output = " << fs::path(options.outputDir).generic_string() << "/\n";
+        if (!ini) return false;
+    }
+
+    configPath = iniPath.string();
+    return true;
+}
+
+// 被测的 LutApplicator 子进程：标准输入接到管道上，结束时写一个回车让它走正常的退出流程
+struct LaunchedApp {
+    HANDLE process = NULL;
+    HANDLE stdinWrite = NULL;
+};
+
+bool launchApp(const std::string& exePath, const std::string& args, LaunchedApp& app) {
+    SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
+    HANDLE readPipe = NULL, writePipe = NULL;
+    if (!CreatePipe(&readPipe, &writePipe, &sa, 0)) return false;
+    SetHandleInformation(writePipe, HANDLE_FLAG_INHERIT, 0); // 写端留在本进程
+
+    STARTUPINFOA si = {};
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = readPipe;
+    si.hStdOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+    si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+    PROCESS_INFORMATION pi = {};
+    std::string commandLine = "\"" + exePath + "\" " + args;
+    BOOL ok = CreateProcessA(NULL, &commandLine[0], NULL, NULL, TRUE, 0, NULL, NULL, &si, &pi);
+    CloseHandle(readPipe);
+    if (!ok) {
+        CloseHandle(writePipe);
+        return false;
+    }
+
+    CloseHandle(pi.hThread);
+    app.process = pi.hProcess;
+    app.stdinWrite = writePipe;
+    return true;
+}
+
+bool appRunning(const LaunchedApp& app) {
+    return app.process != NULL && WaitForSingleObject(app.process, 0) == WAIT_TIMEOUT;
+}
+
+// 发回车让被测程序按正常流程停止（在途输出会写完），超时则强制结束
+// 返回是否在时限内以 0 退出
+bool stopApp(LaunchedApp& app, int timeoutMs) {
+    if (app.process == NULL) return false;
+
+    DWORD written = 0;
+    WriteFile(app.stdinWrite, "\n", 1, &written, NULL);
+    CloseHandle(app.stdinWrite);
+    app.stdinWrite = NULL;
+
+    bool exited = WaitForSingleObject(app.process, timeoutMs) == WAIT_OBJECT_0;
+    DWORD exitCode = 1;
+    if (exited) {
+        GetExitCodeProcess(app.process, &exitCode);
+    }
+    else {
+        TerminateProcess(app.process, 1);
+    }
+
+    CloseHandle(app.process);
+    app.process = NULL;
+    return exited && exitCode == 0;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    return values[std::clamp<size_t>(index, 1, values.size()) - 1];
+}
+
+bool parseOptions(int argc, char* argv[], LoadOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+
+        if (key == "--watch") options.watchDir = value;
+        else if (key == "--out") options.outputDir = value;
+        else if (key == "--count") options.count = std::atoi(value.c_str());
+        else if (key == "--shape") options.shape = value;
+        else if (key == "--rate") options.rate = std::atof(value.c_str());
+        else if (key == "--burst") options.burstSize = std::atoi(value.c_str());
+        else if (key == "--burst-gap-ms") options.burstGapMs = std::atoi(value.c_str());
+        else if (key == "--partial") options.partialRatio = std::atof(value.c_str());
+        else if (key == "--rename") options.renameRatio = std::atof(value.c_str());
+        else if (key == "--rewrite") options.rewriteRatio = std::atof(value.c_str());
+        else if (key == "--rewrite-times") options.rewriteTimes = std::atoi(value.c_str());
+        else if (key == "--size") {
+            size_t x = value.find('x');
+            if (x == std::string::npos) return false;
+            options.width = std::atoi(value.substr(0, x).c_str());
+            options.height = std::atoi(value.substr(x + 1).c_str());
+        }
+        else if (key == "--timeout-ms") options.timeoutMs = std::atoi(value.c_str());
+        else if (key == "--seed") options.seed = static_cast<unsigned int>(std::atoi(value.c_str()));
+        else if (key == "--slo-p99-ms") options.sloP99Ms = std::atof(value.c_str());
+        else if (key == "--slo-min-throughput") options.sloMinThroughput = std::atof(value.c_str());
+        else if (key == "--max-dropped") options.maxDropped = std::atoi(value.c_str());
+        else if (key == "--max-duplicates") options.maxDuplicates = std::atoi(value.c_str());
+        else if (key == "--cleanup") options.cleanup = true;
+        else if (key == "--verify") options.verifyContent = true;
+        else if (key == "--launch") options.launchPath = value;
+        else if (key == "--launch-args") options.launchArgs = value;
+        else if (key == "--work") options.workDir = value;
+        else if (key == "--launch-wait-ms") options.launchWaitMs = std::atoi(value.c_str());
+        else {
+            std::cerr << "未知参数: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    // 自包含模式下目录可以省略，由工作目录派生
+    bool haveDirs = !options.launchPath.empty() || (!options.watchDir.empty() && !options.outputDir.empty());
+    if (!options.launchPath.empty()) options.verifyContent = true; // 自包含模式用的是恒等 LUT
+    return haveDirs && options.count > 0 && options.width > 0 && options.height > 0;
+}
+
+int main(int argc, char* argv[])
+{
+    LoadOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "用法: LutLoadGen (--watch=<监听目录> --out=<输出目录> | --launch=<LutApplicator> [--launch-args=...]\n"
+            << "         [--work=<工作目录>] [--launch-wait-ms=N]) [--count=N] [--shape=steady|burst|ramp]\n"
+            << "         [--rate=文件/秒] [--burst=N] [--burst-gap-ms=N] [--partial=比例] [--rename=比例]\n"
+            << "         [--rewrite=比例] [--rewrite-times=N] [--size=WxH] [--timeout-ms=N] [--seed=N]\n"
+            << "         [--slo-p99-ms=N] [--slo-min-throughput=文件/秒] [--max-dropped=N] [--max-duplicates=N] [--verify] [--cleanup]"
+            << std::endl;
+        return 2;
+    }
+
+    std::cout << "生成样张 " << options.width << "x" << options.height << " ..." << std::endl;
+    std::vector<Fingerprint> fingerprints;
+    std::vector<std::vector<unsigned char>> samples = makeSampleJpegs(options.width, options.height, 8, fingerprints);
+    if (samples.empty()) {
+        std::cerr << "错误: 样张编码失败" << std::endl;
+        return 2;
+    }
+
+    LaunchedApp app;
+    if (!options.launchPath.empty()) {
+        std::string configPath;
+        if (!prepareSoakRoute(options, configPath)) {
+            std::cerr << "错误: 无法在工作目录准备测试路由: " << options.workDir << std::endl;
+            return 2;
+        }
+
+        std::string args = "--config=\"" + configPath + "\" " + options.launchArgs;
+        std::cout << "启动被测程序: " << options.launchPath << " " << args << std::endl;
+        if (!launchApp(options.launchPath, args, app)) {
+            std::cerr << "错误: 无法启动被测程序: " << options.launchPath << std::endl;
+            return 2;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.launchWaitMs));
+        if (!appRunning(app)) {
+            std::cerr << "错误: 被测程序启动后立即退出" << std::endl;
+            stopApp(app, 0);
+            return 1;
+        }
+    }
+
+    // 每次运行使用不同前缀，避免和上一次残留的输出混淆
+    std::string runId = std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    OutputTracker tracker;
+    if (options.verifyContent) tracker.fingerprints = &fingerprints;
+    FolderWatcher outputWatcher;
+    if (!outputWatcher.start(fs::path(options.outputDir).wstring(), onOutputChanged, &tracker)) {
+        std::cerr << "错误: 无法监听输出目录: " << options.outputDir << std::endl;
+        stopApp(app, 0);
+        return 2;
+    }
+
+    // 固定种子，同样的参数每次产生同样的写入序列
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    std::vector<InputRecord> inputs(options.count);
+    int rewrites = 0, partials = 0, renames = 0;
+
+    std::cout << "开始写入 " << options.count << " 个文件（" << options.shape << "）..." << std::endl;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < options.count; ++i) {
+        std::this_thread::sleep_until(start + scheduleOffset(options, i));
+
+        InputRecord& input = inputs[i];
+        input.fileName = "lg_" + runId + "_" + std::to_string(i) + ".jpg";
+
+        bool partial = coin(rng) < options.partialRatio;
+        bool rename = coin(rng) < options.renameRatio;
+        int writes = coin(rng) < options.rewriteRatio ? std::max(1, options.rewriteTimes) : 1;
+        partials += partial;
+        renames += rename;
+        rewrites += writes > 1;
+
+        // 每次写入的内容都不同，据此判断输出是否由最后一次写入生成
+        for (int w = 0; w < writes; ++w) {
+            input.sample = static_cast<int>((i + w) % samples.size());
+            input.arrival = writeInput(options, input.fileName, samples[input.sample], partial, rename);
+        }
+        input.arrived = true;
+    }
+    Clock::time_point lastArrival = Clock::now();
+    std::cout << "写入完成，用时 " << std::chrono::duration<double>(lastArrival - start).count() << " 秒，等待输出..." << std::endl;
+
+    // 有效交付：最终版本写完之后到达，核对内容时还必须由最终版本生成
+    auto isFinal = [&](const InputRecord& input, const Delivery& delivery) {
+        return delivery.time >= input.arrival && (!options.verifyContent || delivery.sample == input.sample);
+    };
+
+    // 等全部交付或超时
+    Clock::time_point deadline = lastArrival + std::chrono::milliseconds(options.timeoutMs);
+    while (Clock::now() < deadline) {
+        int delivered = 0;
+        {
+            std::lock_guard<std::mutex> lock(tracker.mutex);
+            for (const InputRecord& input : inputs) {
+                auto it = tracker.deliveries.find(input.fileName);
+                if (it != tracker.deliveries.end() &&
+                    std::any_of(it->second.begin(), it->second.end(), [&](const Delivery& d) { return isFinal(input, d); })) {
+                    ++delivered;
+                }
+            }
+        }
+        if (delivered == options.count) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    // 多等一会儿，让迟到的重复处理也被统计到
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    outputWatcher.stop();
+
+    // 统计：延迟以最终版本写完为起点，到该时刻之后第一次由最终版本生成的交付为止。
+    // 最终版本写完之前的交付是中间版本的正确输出，单独计数；之后到达却不是最终版本的也单独计数；
+    // 有效交付之后再有有效交付才算重复处理
+    std::vector<double> latenciesMs;
+    int dropped = 0;
+    int duplicates = 0;
+    int intermediates = 0;
+    int staleLate = 0;  // 最终版本写完之后才到、内容却是旧版本的输出
+    int staleFinal = 0; // 结束时留在输出目录里的不是最终版本（被旧结果覆盖）
+    Clock::time_point lastDelivery = start;
+    for (const InputRecord& input : inputs) {
+        auto it = tracker.deliveries.find(input.fileName);
+        if (it == tracker.deliveries.end()) {
+            ++dropped;
+            continue;
+        }
+
+        const std::vector<Delivery>& deliveries = it->second;
+        auto first = deliveries.end();
+        for (auto d = deliveries.begin(); d != deliveries.end(); ++d) {
+            if (d->time < input.arrival) {
+                ++intermediates;
+            }
+            else if (!isFinal(input, *d)) {
+                ++staleLate;
+            }
+            else if (first == deliveries.end()) {
+                first = d;
+            }
+            else {
+                ++duplicates;
+            }
+        }
+        if (first == deliveries.end()) {
+            ++dropped; // 只有针对旧内容的输出
+            continue;
+        }
+
+        if (options.verifyContent &&
+            identifySample(fs::path(options.outputDir) / input.fileName, fingerprints) != input.sample) {
+            ++staleFinal;
+            ++dropped; // 最终版本交付过，但随后被旧版本的结果覆盖
+            continue;
+        }
+
+        latenciesMs.push_back(std::chrono::duration<double, std::milli>(first->time - input.arrival).count());
+        lastDelivery = std::max(lastDelivery, first->time); // 迟到的重复交付不计入吞吐的时间窗口
+    }
+
+    double elapsed = std::chrono::duration<double>(lastDelivery - start).count();
+    double throughput = elapsed > 0.0 ? latenciesMs.size() / elapsed : 0.0;
+    double p50 = percentile(latenciesMs, 50), p95 = percentile(latenciesMs, 95), p99 = percentile(latenciesMs, 99);
+    double maxLatency = latenciesMs.empty() ? 0.0 : *std::max_element(latenciesMs.begin(), latenciesMs.end());
+
+    std::cout << "------------------------------------------------" << std::endl;
+    std::cout << "输入: " << options.count << "（分段写 " << partials << "，改名 " << renames << "，重写 " << rewrites << "）" << std::endl;
+    std::cout << "交付: " << latenciesMs.size() << "  丢失: " << dropped << "  重复处理: " << duplicates << std::endl;
+    std::cout << "中间版本输出: " << intermediates << "（最终版本写完之前交付，不计为重复）" << std::endl;
+    if (options.verifyContent) {
+        std::cout << "旧版本输出: 晚到 " << staleLate << "，最终被旧版本覆盖 " << staleFinal << "（后者计入丢失）" << std::endl;
+    }
+    std::cout << "吞吐: " << throughput << " 文件/秒" << std::endl;
+    std::cout << "延迟(ms): p50=" << p50 << " p95=" << p95 << " p99=" << p99 << " max=" << maxLatency << std::endl;
+
+    bool passed = true;
+    if (dropped > options.maxDropped) {
+        std::cout << "[失败] 丢失 " << dropped << " > " << options.maxDropped << std::endl;
+        passed = false;
+    }
+    if (options.maxDuplicates >= 0 && duplicates > options.maxDuplicates) {
+        std::cout << "[失败] 重复处理 " << duplicates << " > " << options.maxDuplicates << std::endl;
+        passed = false;
+    }
+    if (options.sloP99Ms > 0.0 && p99 > options.sloP99Ms) {
+        std::cout << "[失败] p99 " << p99 << "ms > " << options.sloP99Ms << "ms" << std::endl;
+        passed = false;
+    }
+    if (options.sloMinThroughput > 0.0 && throughput < options.sloMinThroughput) {
+        std::cout << "[失败] 吞吐 " << throughput << " < " << options.sloMinThroughput << std::endl;
+        passed = false;
+    }
+    if (!options.launchPath.empty() && !stopApp(app, 30000)) {
+        std::cout << "[失败] 被测程序未能在 30 秒内正常退出" << std::endl;
+        passed = false;
+    }
+    std::cout << (passed ? "[通过] SLO 达标" : "[失败] SLO 未达标") << std::endl;
+
+    if (options.cleanup) {
+        std::error_code ec;
+        for (const InputRecord& input : inputs) {
+            fs::remove(fs::path(options.watchDir) / input.fileName, ec);
+            fs::remove(fs::path(options.outputDir) / input.fileName, ec);
+            fs::remove(fs::path(options.outputDir) / (input.fileName + ".stats.json"), ec);
+        }
+    }
+
+    return passed ? 0 : 1;
+}